@@ -1,6 +1,7 @@
 #pragma once
 
 #include <functional>
+#include <algorithm>
 #include <memory>
 #include <chrono>
 #include <string>
@@ -8,7 +9,12 @@
 #include <thread>
 #include <atomic>
 #include <mutex>
+#include <condition_variable>
 #include <shared_mutex>
+#include <set>
+#include <variant>
+#include <type_traits>
+#include <sstream>
 #include <unordered_set>
 #include <unordered_map>
 
@@ -43,6 +49,22 @@ protected:
     void* events_exporter_hinst = nullptr;
     std::mutex events_m;
 
+    // Event ingestion. Each producer thread pushes events to its own ring, and the rings are drained by the ingestion worker.
+    std::unordered_map<std::thread::id, std::unique_ptr<events::EventRing>> event_rings;
+    std::vector<events::EventRing*> event_rings_drained;
+    std::mutex event_rings_m;
+    // Only one consumer drains the rings at a time.
+    std::mutex ingestion_m;
+    std::thread ingestion_thread;
+    std::atomic<bool> ingesting = false;
+    // If false, the events are ingested on the producer threads.
+    bool async_ingestion = true;
+    // The ingestion worker parks when the rings stay empty, and is woken by the next pushed event.
+    std::mutex ingestion_wait_m;
+    std::condition_variable ingestion_cv;
+    std::atomic<bool> ingestion_parked = false;
+    size_t serial;
+
     std::unique_ptr<MemoryScheduler> scheduler;
     void* scheduler_hinst = nullptr;
     std::unique_ptr<exporter::ScheduleExporter> schedule_exporter;
@@ -55,22 +77,133 @@ protected:
     std::thread scheduler_thread;
     std::recursive_mutex scheduler_mutex;
     int sleep_interval = 5;     // millisecond
+    int ingestion_interval = 100;   // microsecond
+    int ingestion_idle_rounds = 16; // empty drains before the ingestion worker parks
+
+protected:
+    events::EventRing& locateEventRing() {
+        // Cache of the ring of this thread. Backends are distinguished by serial rather than address, which may be reused.
+        thread_local size_t cached_serial = 0;
+        thread_local events::EventRing* cached_ring = nullptr;
+        if (cached_serial == serial) return *cached_ring;
+
+        std::unique_lock<std::mutex> l{event_rings_m};
+        auto p = event_rings.find(std::this_thread::get_id());
+        if (p == event_rings.end()) {
+            p = event_rings.emplace(std::this_thread::get_id(), std::unique_ptr<events::EventRing>(new events::EventRing())).first;
+            event_rings_drained.push_back(p->second.get());
+        }
+        cached_serial = serial;
+        cached_ring   = p->second.get();
+        return *cached_ring;
+    }
+
+    void ingestEvent(const events::EventRing::Record& record) {
+        std::visit([this](const auto& event) {
+            std::unique_lock<std::mutex> l{events_m};
+            events.submitEvent(event);
+            if constexpr (std::is_same<std::decay_t<decltype(event)>, events::MemoryEvent>::value) events_exporter->onMemoryEvent(event);
+            else events_exporter->onExecutionEvent(event);
+            l.unlock();
+            scheduler->submitEvent(event);
+        }, record);
+    }
+
+    /**
+     * drainEvents
+     * Store, export and schedule the events pushed so far, in the order of timestamps.
+     * @return count of events drained
+     */
+    size_t drainEvents() {
+        std::unique_lock<std::mutex> li{ingestion_m};
+        std::unique_lock<std::mutex> lr{event_rings_m};
+        std::vector<events::EventRing*> rings = event_rings_drained;
+        lr.unlock();
+
+        return events::EventRing::drain(rings, [this](const events::EventRing::Record& record) { ingestEvent(record); });
+    }
+
+    bool isIngestionDrained() {
+        std::unique_lock<std::mutex> lr{event_rings_m};
+        return std::all_of(event_rings_drained.begin(), event_rings_drained.end(), [](const events::EventRing* ring) { return ring->empty(); });
+    }
+
+    void pushEvent(const events::EventRing::Record& record) {
+        if (!async_ingestion) {
+            std::unique_lock<std::mutex> li{ingestion_m};
+            ingestEvent(record);
+            return;
+        }
+
+        events::EventRing& ring = locateEventRing();
+        // Wait for the ingestion worker if it falls behind, so that the scheduler does not run on the producer thread.
+        // Only if the worker is already stopped, the events are drained by the producer.
+        while (!ring.push(record)) {
+            if (ingesting) std::this_thread::yield();
+            else drainEvents();
+        }
+
+        // Pairs with the fence of the parking worker, so that either the worker sees the event or the producer sees it parked.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (ingestion_parked.load(std::memory_order_relaxed)) {
+            std::unique_lock<std::mutex> lw{ingestion_wait_m};
+            ingestion_cv.notify_one();
+        }
+    }
+
+    void ingest() {
+        int idle_rounds = 0;
+        while (ingesting) {
+            if (drainEvents() != 0) {
+                idle_rounds = 0;
+                continue;
+            }
+            if (++idle_rounds < ingestion_idle_rounds) {
+                std::this_thread::sleep_for(std::chrono::microseconds{ingestion_interval});
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lw{ingestion_wait_m};
+            ingestion_parked.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            ingestion_cv.wait(lw, [this]() { return !ingesting || !isIngestionDrained(); });
+            ingestion_parked.store(false, std::memory_order_relaxed);
+            idle_rounds = 0;
+        }
+    }
 
 public:
     BasicBackend(Context _context) {
+        static std::atomic<size_t> serial_counter = 0;
+        serial = ++serial_counter;
+
         context = _context;
+        async_ingestion = context.signal("events.async");
+
+        // Set up event retention
+        std::set<int> pinned_iterations;
+        std::stringstream pinned_ss(context.at("events.retention.pinned"));
+        std::string pinned_iteration;
+        while (std::getline(pinned_ss, pinned_iteration, ',')) {
+            if (!pinned_iteration.empty()) pinned_iterations.insert(std::stoi(pinned_iteration));
+        }
+        events.setRetention(std::stoul(context.at("events.retention")), pinned_iterations);
 
         // Set up scheduler
         std::string scheduler_name = context.at("scheduler");
         Context::View scheduler_context = context.view("scheduler");
         if (scheduler_name == "section") scheduler = std::unique_ptr<MemoryScheduler>(new SectionAwareMemoryScheduler(scheduler_context, status, events));
         else if (scheduler_name == "dependency") scheduler = std::unique_ptr<MemoryScheduler>(new DependencyAwareMemoryScheduler(scheduler_context, status, events));
+        else if (scheduler_name == "recompute") scheduler = std::unique_ptr<MemoryScheduler>(new RecomputationAwareMemoryScheduler(scheduler_context, status, events));
+        else if (scheduler_name == "optimal") scheduler = std::unique_ptr<MemoryScheduler>(new CostOptimalMemoryScheduler(scheduler_context, status, events));
         else scheduler_hinst = utils::load_dylib("Scheduler", context.at("scheduler.path"), "scheduler_entry", scheduler, scheduler_context);
 
         // Set up events exporter
         std::string events_exporter_name = context.at("exporters.events");
         if (events_exporter_name == "empty") events_exporter = std::unique_ptr<exporter::EventsExporter>(new exporter::EventsExporter(context.view("exporters.events")));
+        else if (events_exporter_name == "binary") events_exporter = std::unique_ptr<exporter::EventsExporter>(new exporter::BinaryEventsExporter(context.view("exporters.events")));
         else events_exporter_hinst = utils::load_dylib("Events Exporter", context.at("exporters.events.path"), "events_exporter_entry", events_exporter, context.view("exporters.events"));
+        events_exporter->setMemoryStatus(status);
 
         // Set up tensors exporter
         std::string tensors_exporter_name = context.at("exporters.tensors");
@@ -91,7 +224,22 @@ public:
     }
 
     virtual void submitMemoryStatus(const status::MemoryStatus& _status) override {
+        // The status is shared with the frontend, and only the modified parts are copied later.
+        std::unique_lock<std::mutex> li{ingestion_m};
+        bool updated = status.getVersion() != _status.getVersion();
         status = _status;
+        if (updated) tensors_exporter->onTensors(status);
+    }
+
+    virtual void submitMemoryStatusDelta(const status::MemoryStatusDelta& delta) override {
+        if (!inited) throw uninited_exception();
+        if (delta.empty()) return;
+
+        // The events submitted before the modifications are ingested first.
+        if (started) drainEvents();
+        // Modifications are applied to the status of the backend, hence the modifications of the backend, e.g. fragments, are kept.
+        std::unique_lock<std::mutex> li{ingestion_m};
+        status.apply(delta);
         tensors_exporter->onTensors(status);
     }
 
@@ -100,6 +248,13 @@ public:
         if (started) throw inited_exception();
 
         started = true;
+        // Lookups from the schedule requests run concurrently with the modifications by the status deltas.
+        status.setConcurrent(true);
+
+        if (async_ingestion) {
+            ingesting = true;
+            ingestion_thread = std::thread([this]() { ingest(); });
+        }
 
         // Init scheduler
         // scheduler->init();
@@ -119,30 +274,32 @@ public:
     virtual void submitEvent(const events::MemoryEvent& event) override {
         if (!inited) throw uninited_exception();
         if (!started) throw uninited_exception();
-
-        std::unique_lock<std::mutex> l{events_m};
-        events.submitEvent(event);
-        events_exporter->onMemoryEvent(event);
-        l.unlock();
-        scheduler->submitEvent(event);
+        pushEvent(event);
     }
 
     virtual void submitEvent(const events::ExecutionEvent& event) override {
         if (!inited) throw uninited_exception();
         if (!started) throw uninited_exception();
+        pushEvent(event);
+    }
+
+    virtual void submitLayoutStatistics(const std::vector<layout::BlockStatistics>& statistics) override {
+        if (!inited) throw uninited_exception();
+        if (!started) throw uninited_exception();
 
         std::unique_lock<std::mutex> l{events_m};
-        events.submitEvent(event);
-        events_exporter->onExecutionEvent(event);
-        l.unlock();
-        scheduler->submitEvent(event);
+        events_exporter->onLayoutStatistics(events.getIteration(), statistics);
     }
 
     virtual events::ScheduleEvents getScheduleEvents() override {
         if (!inited) throw uninited_exception();
         if (!started) throw uninited_exception();
 
+        drainEvents();
+        // The scheduler is not accessed concurrently with the ingestion.
+        std::unique_lock<std::mutex> li{ingestion_m};
         events::ScheduleEvents&& re = scheduler->getScheduleEvents();
+        li.unlock();
         for (auto &x : re.memory_map.getFragmentInfo()) {
             status::TensorPres pres = status.referenceTensor(x.first);
             pres.setFragment(x.second);
@@ -162,7 +319,14 @@ public:
         return events.getIteration();
     }
 
-    virtual void setIteration(int _iteration) override { events.setIteration(_iteration); }
+    virtual void setIteration(int _iteration) override {
+        // Events are attributed to the iteration when they are drained.
+        drainEvents();
+        std::unique_lock<std::mutex> li{ingestion_m};
+        std::unique_lock<std::mutex> l{events_m};
+        events.setIteration(_iteration);
+        events_exporter->onIteration(events.getIteration(), false);
+    }
 
     /**
      * newIteration
@@ -174,8 +338,15 @@ public:
         if (!inited) throw uninited_exception();
         if (!started) throw uninited_exception();
         // Block to synchorize with scheduler.
+        drainEvents();
+        std::unique_lock<std::mutex> li{ingestion_m};
+        std::unique_lock<std::mutex> l{events_m};
         events.newIteration();
+        events_exporter->onIteration(events.getIteration(), true);
+        l.unlock();
         scheduler->newIteration();
+        li.unlock();
+        status.reclaim();
     }
 
     virtual void halfIteration() override {
@@ -190,6 +361,13 @@ public:
         started = false;
         // Examine if the thread terminates properly
         if (scheduler_thread.joinable()) scheduler_thread.join();
+
+        std::unique_lock<std::mutex> lw{ingestion_wait_m};
+        ingesting = false;
+        ingestion_cv.notify_all();
+        lw.unlock();
+        if (ingestion_thread.joinable()) ingestion_thread.join();
+        drainEvents();
     }
 
     virtual void terminate() override {
@@ -200,6 +378,9 @@ public:
     }
 
     virtual ~BasicBackend() {
+        ingesting = false;
+        if (ingestion_thread.joinable()) ingestion_thread.join();
+
         scheduler.release();
         events_exporter.release();
         tensors_exporter.release();
@@ -65,9 +65,9 @@ protected:
     void fillModel(status::MemoryStatus& status) {
         std::string entry = status.getEntry();
         for (auto &so : status.getExecutionOrder()) {
-            status::OperatorPres op_pres = status.referenceOperator(so);
+            status::ConstOperatorPres op_pres = status.referenceConstOperator(so);
             for (auto &st : op_pres.getTensors()) {
-                status::TensorPres tensor_pres = status.referenceTensor(st);
+                status::ConstTensorPres tensor_pres = status.referenceConstTensor(st);
                 if (tensor_pres.isPersistent() || tensor_pres.isTransient()) continue;
                 // Do submit here.
                 layout::Layer& l = memory_map_builer.getCurrentLayer();
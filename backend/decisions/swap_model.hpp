@@ -0,0 +1,221 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include "backend/schedulers/schedule_utils.hpp"
+
+namespace mori {
+namespace decisions {
+
+/**
+ * SwapModel
+ * Plan the swapping of tensors over the operator sequence of an iteration, minimizing the predicted stall subject to the device capacity.
+ * Operators are indexed by position in the sequence. The demand of an operator is the size of tensors resident during its execution.
+ * A swapped tensor is not resident from the operator where its swapping out completes, to the operator where its swapping in (prefetching) is issued.
+ * Timespans are in microseconds.
+ */
+struct SwapModel final {
+public:
+    struct Candidate final {
+        std::string name;
+        size_t size     = 0;
+        long   transfer = 0;    // Transferring time of swapping in or out.
+        int    acquired = 0;    // Position of the last access before swapping out.
+        int    accessed = 0;    // Position of the first access after swapping in.
+        int    earliest = 0;    // The earliest position the prefetching can be issued at.
+
+        Candidate() = default;
+        Candidate(const std::string& _name, size_t _size, long _transfer, int _acquired, int _accessed, int _earliest): name(_name), size(_size), transfer(_transfer), acquired(_acquired), accessed(_accessed), earliest(_earliest) {}
+    };  // inner struct Candidate
+
+    struct Decision final {
+        std::string name;
+        size_t size     = 0;
+        bool   swapped  = false;
+        int    released = 0;    // Position where the tensor becomes non-resident.
+        int    prefetch = 0;    // Position where the prefetching is issued. Equals to the access position if swapped in on demand.
+        long   stall    = 0;
+    };  // inner struct Decision
+
+private:
+    size_t capacity   = 0;
+    size_t resolution = 4096;
+
+    std::vector<size_t> demands;
+    std::vector<long>   timespans;
+    std::vector<Candidate> candidates;
+
+    std::vector<Decision> decisions;
+    std::vector<size_t>   releases;
+    size_t predicted_peak  = 0;
+    long   predicted_stall = 0;
+
+protected:
+    inline size_t getDeficit(int posi) const { return demands[posi] > capacity ? demands[posi] - capacity : 0; }
+    inline size_t getResidual(int posi) const {
+        size_t deficit = getDeficit(posi);
+        return deficit > releases[posi] ? deficit - releases[posi] : 0;
+    }
+
+    long getStall(const Candidate& candidate, int prefetch) const {
+        long overlapped = 0;
+        for (int i = prefetch; i < candidate.accessed; ++i) overlapped += timespans[i];
+        return candidate.transfer > overlapped ? candidate.transfer - overlapped : 0;
+    }
+
+    /**
+     * Swapping out is overlapped with the execution after the last access. Memory is released when the transferring completes.
+     */
+    int getReleasePosition(const Candidate& candidate) const {
+        int posi = candidate.acquired + 1;
+        long overlapped = 0;
+        while (posi < candidate.accessed && overlapped < candidate.transfer) overlapped += timespans[posi++];
+        return posi;
+    }
+
+    void applyRelease(const Decision& decision, bool release) {
+        for (int i = decision.released; i < decision.prefetch; ++i) {
+            if (release) releases[i] += decision.size;
+            else releases[i] -= decision.size;
+        }
+    }
+
+    bool isReleaseRemovable(const Decision& decision, int begin, int end) const {
+        for (int i = begin; i < end; ++i) {
+            if (releases[i] < decision.size) return false;
+            if (releases[i] - decision.size < getDeficit(i)) return false;
+        }
+        return true;
+    }
+
+    /**
+     * Select the tensors to release the memory at the position, with the minimal transferring time.
+     */
+    std::vector<size_t> selectCandidates(int posi, const std::vector<size_t>& available) const {
+        std::vector<size_t> sizes;
+        std::vector<long>   transfers;
+        for (auto n : available) {
+            sizes.push_back(decisions[n].size);
+            transfers.push_back(candidates[n].transfer);
+        }
+        std::vector<size_t> re = utils::select_covering(sizes, transfers, getResidual(posi), resolution);
+        for (auto &x : re) x = available[x];
+        return re;
+    }
+
+    void selectSwapping() {
+        while (true) {
+            int posi = -1;
+            for (size_t i = 0; i < demands.size(); ++i) {
+                if (getResidual(i) == 0) continue;
+                if (posi == -1 || getResidual(i) > getResidual(posi)) posi = i;
+            }
+            if (posi == -1) break;
+
+            std::vector<size_t> available;
+            for (size_t n = 0; n < decisions.size(); ++n) {
+                const Decision& decision = decisions[n];
+                if (decision.swapped) continue;
+                if (decision.released <= posi && posi < decision.prefetch) available.push_back(n);
+            }
+            if (available.empty()) break;   // Infeasible, the capacity is exceeded at this position.
+
+            std::vector<size_t> selected = selectCandidates(posi, available);
+            // Not enough memory could be released. Release as much as possible.
+            if (selected.empty()) selected = available;
+            for (auto n : selected) {
+                decisions[n].swapped = true;
+                applyRelease(decisions[n], true);
+            }
+        }
+
+        // Covering at the positions selected later may make the former selection redundant.
+        std::vector<size_t> order;
+        for (size_t n = 0; n < decisions.size(); ++n) if (decisions[n].swapped) order.push_back(n);
+        std::sort(order.begin(), order.end(), [this](size_t x, size_t y) { return candidates[x].transfer > candidates[y].transfer; });
+        for (auto n : order) {
+            Decision& decision = decisions[n];
+            if (!isReleaseRemovable(decision, decision.released, decision.prefetch)) continue;
+            applyRelease(decision, false);
+            decision.swapped = false;
+        }
+    }
+
+    /**
+     * Issue the prefetching as early as the capacity allows, which reduces the stall.
+     */
+    void placePrefetching() {
+        std::vector<size_t> order;
+        for (size_t n = 0; n < decisions.size(); ++n) if (decisions[n].swapped) order.push_back(n);
+        std::sort(order.begin(), order.end(), [this](size_t x, size_t y) { return candidates[x].transfer > candidates[y].transfer; });
+
+        for (auto n : order) {
+            Decision& decision = decisions[n];
+            const Candidate& candidate = candidates[n];
+            int lower = std::max(decision.released + 1, candidate.earliest);
+            int prefetch = decision.prefetch;
+            while (prefetch > lower && getStall(candidate, prefetch) > 0) {
+                if (!isReleaseRemovable(decision, prefetch - 1, prefetch)) break;
+                --prefetch;
+                releases[prefetch] -= decision.size;
+            }
+            decision.prefetch = prefetch;
+        }
+    }
+
+public:
+    SwapModel() = default;
+
+    inline void setCapacity(size_t _capacity) { capacity = _capacity; }
+    inline void setResolution(size_t _resolution) { resolution = std::max<size_t>(1, _resolution); }
+
+    /**
+     * Set the demand and the execution timespan of each operator in the sequence.
+     */
+    void setSequence(const std::vector<size_t>& _demands, const std::vector<long>& _timespans) {
+        demands   = _demands;
+        timespans = _timespans;
+        timespans.resize(demands.size(), 0);
+    }
+
+    void submitCandidate(const Candidate& candidate) { candidates.push_back(candidate); }
+    void clearCandidates() { candidates.clear(); }
+
+    void analyze() {
+        decisions.clear();
+        releases.assign(demands.size(), 0);
+
+        for (auto &x : candidates) {
+            Decision& decision = decisions.emplace_back();
+            decision.name     = x.name;
+            decision.size     = x.size;
+            decision.released = getReleasePosition(x);
+            decision.prefetch = x.accessed;
+        }
+
+        selectSwapping();
+        placePrefetching();
+
+        predicted_peak  = 0;
+        predicted_stall = 0;
+        for (size_t i = 0; i < demands.size(); ++i) {
+            // Releasing beyond the demand leaves nothing resident.
+            if (demands[i] > releases[i]) predicted_peak = std::max(predicted_peak, demands[i] - releases[i]);
+        }
+        for (size_t n = 0; n < decisions.size(); ++n) {
+            Decision& decision = decisions[n];
+            if (!decision.swapped) continue;
+            decision.stall = getStall(candidates[n], decision.prefetch);
+            predicted_stall += decision.stall;
+        }
+    }
+
+    inline const std::vector<Decision>& getDecisions() const noexcept { return decisions; }
+    inline size_t getPredictedPeakMemory() const noexcept { return predicted_peak; }
+    inline long   getPredictedStall()      const noexcept { return predicted_stall; }
+};  // struct SwapModel
+
+}   // namespace decisions
+}   // namespace mori
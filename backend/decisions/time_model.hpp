@@ -13,16 +13,18 @@ namespace mori {
 namespace decisions {
 
 struct TransferringModel {
+    // Transferring time in microseconds.
     long analyze(size_t size) {
         // long t = size / 1048576;
         // return t / 12;
-        return size >> 2;
+        return (size >> 2) * 1000;
     }
 
 };  // struct TransferModel
 
 struct TimeModel final {
 public:
+    // Spans and timepoints are in microseconds.
     struct Timespan final {
         std::string target;
         long span = 0;
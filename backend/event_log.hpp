@@ -0,0 +1,296 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <fstream>
+#include <cstring>
+#include <cstdint>
+#include <chrono>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#include "includes/symbols.hpp"
+#include "includes/memory_event.hpp"
+#include "includes/execution_event.hpp"
+#include "includes/exceptions/event_exceptions.hpp"
+
+namespace mori {
+namespace events {
+
+/**
+ * Binary event log.
+ * The log is made of two append-only files. The record file holds fixed-size records of the events, and the string table file (with suffix .strings) holds the names of the handles.
+ * Each file starts with a header, whose size field counts the valid bytes after the header, so a log left by a crashed process remains readable.
+ */
+namespace eventlog {
+
+enum struct RecordKind : uint8_t {
+    memory, execution, iteration
+};  // enum struct RecordKind
+
+enum struct NameKind : uint8_t {
+    tensor, op
+};  // enum struct NameKind
+
+struct FileHeader final {
+    char     magic[8];
+    uint32_t version;
+    uint32_t record_size;
+    uint64_t size;
+};  // struct FileHeader
+
+struct Record final {
+    RecordKind kind;
+    uint8_t    type;
+    uint8_t    stage;
+    uint8_t    reserved;
+    int32_t    iteration;
+    uint64_t   op;
+    uint64_t   tensor;
+    uint64_t   size;
+    int64_t    timestamp;   // microseconds
+    int64_t    stall;       // microseconds
+};  // struct Record
+
+static_assert(sizeof(Record) == 48, "Event log record layout changed.");
+
+struct NameHeader final {
+    NameKind kind;
+    uint8_t  reserved[3];
+    uint32_t length;
+    uint64_t id;
+};  // struct NameHeader
+
+static constexpr char     record_magic[8] = {'M', 'O', 'R', 'I', 'E', 'V', 'T', '\0'};
+static constexpr char     string_magic[8] = {'M', 'O', 'R', 'I', 'S', 'T', 'R', '\0'};
+static constexpr uint32_t version = 2;
+
+/**
+ * Append-only file written through a memory mapping. The mapping grows by doubling.
+ */
+struct MappedFile final {
+private:
+    int      fd       = -1;
+    uint8_t* base     = nullptr;
+    size_t   capacity = 0;
+
+    inline FileHeader* header() { return reinterpret_cast<FileHeader*>(base); }
+
+    void map(size_t _capacity) {
+        if (base) munmap(base, capacity);
+        base = nullptr;
+        if (ftruncate(fd, _capacity) != 0) throw event_conflict("Event log cannot be extended.");
+        void* p = mmap(nullptr, _capacity, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (p == MAP_FAILED) throw event_conflict("Event log cannot be mapped.");
+        base     = static_cast<uint8_t*>(p);
+        capacity = _capacity;
+    }
+
+public:
+    MappedFile() = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    void open(const std::string& path, const char* magic, uint32_t record_size, size_t initial_capacity = 1048576) {
+        close();
+        fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd == -1) throw event_conflict("Event log cannot be opened: " + path);
+        map(initial_capacity < sizeof(FileHeader) ? sizeof(FileHeader) : initial_capacity);
+
+        FileHeader* h = header();
+        std::memcpy(h->magic, magic, sizeof(h->magic));
+        h->version     = version;
+        h->record_size = record_size;
+        h->size        = 0;
+    }
+
+    inline bool isOpened() const noexcept { return fd != -1; }
+
+    void append(const void* data, size_t length) {
+        size_t end = sizeof(FileHeader) + header()->size;
+        if (end + length > capacity) {
+            size_t target = capacity;
+            while (end + length > target) target <<= 1;
+            map(target);
+        }
+        std::memcpy(base + end, data, length);
+        // The data is visible to readers only after the size is updated.
+        header()->size += length;
+    }
+
+    void close() {
+        if (fd == -1) return;
+        size_t end = sizeof(FileHeader) + header()->size;
+        munmap(base, capacity);
+        base     = nullptr;
+        capacity = 0;
+        // Trim the unused tail of the mapping.
+        if (ftruncate(fd, end) != 0) {}
+        ::close(fd);
+        fd = -1;
+    }
+
+    ~MappedFile() { close(); }
+};  // struct MappedFile
+
+}   // namespace eventlog
+
+/**
+ * EventLogWriter
+ * Append events to the binary event log. Not thread-safe, the caller serializes the appending.
+ */
+struct EventLogWriter final {
+private:
+    eventlog::MappedFile records;
+    eventlog::MappedFile strings;
+
+    std::vector<bool> tensor_named;
+    std::vector<bool> op_named;
+
+    static bool markNamed(std::vector<bool>& named, size_t id) {
+        if (id >= named.size()) named.resize(id + 1, false);
+        if (named[id]) return false;
+        named[id] = true;
+        return true;
+    }
+
+public:
+    void open(const std::string& path) {
+        records.open(path, eventlog::record_magic, sizeof(eventlog::Record));
+        strings.open(path + ".strings", eventlog::string_magic, 0);
+        tensor_named.clear();
+        op_named.clear();
+    }
+
+    inline bool isOpened() const noexcept { return records.isOpened(); }
+
+    inline bool isTensorNamed(TensorId tensor) const { return tensor < tensor_named.size() && tensor_named[tensor]; }
+    inline bool isOperatorNamed(OperatorId op) const { return op < op_named.size() && op_named[op]; }
+
+    void appendName(eventlog::NameKind kind, size_t id, const std::string& name) {
+        if (!markNamed(kind == eventlog::NameKind::tensor ? tensor_named : op_named, id)) return;
+        eventlog::NameHeader header;
+        std::memset(&header, 0, sizeof(header));
+        header.kind   = kind;
+        header.length = name.size();
+        header.id     = id;
+        strings.append(&header, sizeof(header));
+        strings.append(name.data(), name.size());
+    }
+
+    void append(int iteration, const MemoryEvent& event) {
+        eventlog::Record record;
+        std::memset(&record, 0, sizeof(record));
+        record.kind      = eventlog::RecordKind::memory;
+        record.type      = static_cast<uint8_t>(event.type);
+        record.stage     = static_cast<uint8_t>(event.stage);
+        record.iteration = iteration;
+        record.op        = event.op;
+        record.tensor    = event.tensor;
+        record.size      = event.size;
+        record.timestamp = mori::utils::get_timestamp_val(event.timestamp);
+        record.stall     = event.stall;
+        records.append(&record, sizeof(record));
+    }
+
+    void append(int iteration, const ExecutionEvent& event) {
+        eventlog::Record record;
+        std::memset(&record, 0, sizeof(record));
+        record.kind      = eventlog::RecordKind::execution;
+        record.type      = static_cast<uint8_t>(event.type);
+        record.stage     = static_cast<uint8_t>(event.stage);
+        record.iteration = iteration;
+        record.op        = event.op;
+        record.tensor    = invalid_id;
+        record.timestamp = mori::utils::get_timestamp_val(event.timestamp);
+        records.append(&record, sizeof(record));
+    }
+
+    /**
+     * Mark the start of an iteration. Replaying triggers the iteration of the scheduler at the marks.
+     */
+    void appendIteration(int iteration) {
+        eventlog::Record record;
+        std::memset(&record, 0, sizeof(record));
+        record.kind      = eventlog::RecordKind::iteration;
+        record.iteration = iteration;
+        record.op        = invalid_id;
+        record.tensor    = invalid_id;
+        record.timestamp = mori::utils::get_timestamp_val(std::chrono::steady_clock::now());
+        records.append(&record, sizeof(record));
+    }
+
+    void close() {
+        records.close();
+        strings.close();
+    }
+};  // struct EventLogWriter
+
+/**
+ * EventLogReader
+ * Load the binary event log. Handles in the records refer to the names in the string table.
+ */
+struct EventLogReader final {
+private:
+    std::vector<eventlog::Record> records;
+    std::unordered_map<TensorId, std::string>   tensor_names;
+    std::unordered_map<OperatorId, std::string> op_names;
+
+    static std::vector<char> loadFile(const std::string& path, const char* magic) {
+        std::ifstream fin(path, std::ios::binary);
+        if (!fin) throw event_conflict("Event log cannot be opened: " + path);
+
+        eventlog::FileHeader header;
+        if (!fin.read(reinterpret_cast<char*>(&header), sizeof(header))) throw event_conflict("Event log header corrupted: " + path);
+        if (std::memcmp(header.magic, magic, sizeof(header.magic)) != 0) throw event_conflict("Not an event log: " + path);
+        if (header.version != eventlog::version) throw event_conflict("Event log version mismatch: " + path);
+
+        std::vector<char> re(header.size);
+        if (!fin.read(re.data(), re.size())) throw event_conflict("Event log truncated: " + path);
+        return re;
+    }
+
+public:
+    EventLogReader() = default;
+    EventLogReader(const std::string& path) { open(path); }
+
+    void open(const std::string& path) {
+        records.clear();
+        tensor_names.clear();
+        op_names.clear();
+
+        std::vector<char> data = loadFile(path, eventlog::record_magic);
+        records.resize(data.size() / sizeof(eventlog::Record));
+        std::memcpy(records.data(), data.data(), records.size() * sizeof(eventlog::Record));
+
+        data = loadFile(path + ".strings", eventlog::string_magic);
+        size_t posi = 0;
+        while (posi + sizeof(eventlog::NameHeader) <= data.size()) {
+            eventlog::NameHeader header;
+            std::memcpy(&header, data.data() + posi, sizeof(header));
+            posi += sizeof(header);
+            if (posi + header.length > data.size()) break;
+            std::string name(data.data() + posi, header.length);
+            posi += header.length;
+            if (header.kind == eventlog::NameKind::tensor) tensor_names.emplace(header.id, std::move(name));
+            else op_names.emplace(header.id, std::move(name));
+        }
+    }
+
+    inline const std::vector<eventlog::Record>& getRecords() const noexcept { return records; }
+
+    inline bool isTensorNamed(TensorId tensor) const { return tensor_names.find(tensor) != tensor_names.end(); }
+    inline bool isOperatorNamed(OperatorId op) const { return op_names.find(op) != op_names.end(); }
+    inline const std::string& getTensorName(TensorId tensor) const { return tensor_names.at(tensor); }
+    inline const std::string& getOperatorName(OperatorId op) const { return op_names.at(op); }
+
+    static std::chrono::steady_clock::time_point getTimestamp(const eventlog::Record& record) {
+        return std::chrono::steady_clock::time_point(std::chrono::duration_cast<std::chrono::steady_clock::duration>(mori::utils::TimeUnit(record.timestamp)));
+    }
+};  // struct EventLogReader
+
+}   // namespace events
+}   // namespace mori
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <string>
+#include <functional>
+
+#include "backend/events.hpp"
+#include "backend/event_log.hpp"
+#include "backend/schedulers/memory_scheduler.hpp"
+#include "includes/memory_status.hpp"
+#include "includes/memory_schedule_event.hpp"
+
+namespace mori {
+namespace events {
+
+/**
+ * EventReplayer
+ * Feed the events of a binary event log to a scheduler offline, for reproducing the schedules.
+ * The memory status should be set up as in the recorded run, by registering the same model. Handles are resolved by name, so they need not be identical to the recorded ones.
+ */
+struct EventReplayer final {
+public:
+    using IterationCallback = std::function<void(int, const ScheduleEvents&)>;
+
+private:
+    const EventLogReader& reader;
+    status::MemoryStatus& status;
+    Events& events;
+    MemoryScheduler& scheduler;
+
+    std::unordered_map<TensorId, TensorId>     tensor_handles;
+    std::unordered_map<OperatorId, OperatorId> op_handles;
+
+    /**
+     * Resolve the recorded handle to the handle in the memory status.
+     * @return false if the handle is not named in the log or not registered in the status.
+     */
+    template <typename T, typename F, typename G>
+    static bool resolve(std::unordered_map<T, T>& handles, T recorded, T& resolved, const F& is_named, const G& lookup) {
+        if (recorded == invalid_id) {
+            resolved = invalid_id;
+            return true;
+        }
+        auto p = handles.find(recorded);
+        if (p == handles.end()) {
+            T target = invalid_id;
+            if (is_named(recorded)) {
+                try { target = lookup(recorded); } catch (status_exception&) {}
+            }
+            p = handles.emplace(recorded, target).first;
+        }
+        resolved = p->second;
+        return resolved != invalid_id;
+    }
+
+    bool resolveTensor(TensorId recorded, TensorId& resolved) {
+        return resolve(tensor_handles, recorded, resolved,
+            [this](TensorId tensor) { return reader.isTensorNamed(tensor); },
+            [this](TensorId tensor) { return status.getTensorId(reader.getTensorName(tensor)); });
+    }
+
+    bool resolveOperator(OperatorId recorded, OperatorId& resolved) {
+        return resolve(op_handles, recorded, resolved,
+            [this](OperatorId op) { return reader.isOperatorNamed(op); },
+            [this](OperatorId op) { return status.getOperatorId(reader.getOperatorName(op)); });
+    }
+
+public:
+    EventReplayer(const EventLogReader& _reader, status::MemoryStatus& _status, Events& _events, MemoryScheduler& _scheduler): reader(_reader), status(_status), events(_events), scheduler(_scheduler) {}
+
+    /**
+     * replay
+     * Submit the recorded events to the events and the scheduler, and start the iterations at the recorded marks.
+     * @param callback invoked with the schedule events at the start of each iteration
+     * @return count of events replayed. Events of unresolvable handles are skipped.
+     */
+    size_t replay(const IterationCallback& callback = nullptr) {
+        size_t re = 0;
+        for (auto &x : reader.getRecords()) {
+            if (x.kind == eventlog::RecordKind::iteration) {
+                events.newIteration();
+                scheduler.newIteration();
+                if (callback) callback(events.getIteration(), scheduler.getScheduleEvents());
+                continue;
+            }
+
+            if (x.iteration != events.getIteration()) events.setIteration(x.iteration);
+
+            OperatorId op;
+            if (!resolveOperator(x.op, op)) continue;
+
+            if (x.kind == eventlog::RecordKind::memory) {
+                TensorId tensor;
+                if (!resolveTensor(x.tensor, tensor)) continue;
+                MemoryEvent event(op, tensor, x.size, static_cast<MemoryEventType>(x.type), static_cast<ApplicationStage>(x.stage), EventLogReader::getTimestamp(x), x.stall);
+                events.submitEvent(event);
+                scheduler.submitEvent(event);
+            } else {
+                ExecutionEvent event(op, static_cast<ExecutionEventType>(x.type), static_cast<ApplicationStage>(x.stage), EventLogReader::getTimestamp(x));
+                events.submitEvent(event);
+                scheduler.submitEvent(event);
+            }
+            ++re;
+        }
+        return re;
+    }
+};  // struct EventReplayer
+
+}   // namespace events
+}   // namespace mori
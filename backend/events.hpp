@@ -2,9 +2,19 @@
 
 #include <functional>
 #include <string>
-#include <set>
+#include <vector>
 #include <map>
+#include <memory>
+#include <iterator>
+#include <set>
 #include <utility>
+#include <algorithm>
+#include <optional>
+#include <variant>
+#include <array>
+#include <atomic>
+#include <type_traits>
+#include <unordered_map>
 #include <cassert>
 
 #include "backend/exporters.hpp"
@@ -13,6 +23,205 @@
 namespace mori {
 namespace events {
 
+/**
+ * EventFilter
+ * Equality conditions of an event query, which can be resolved by the indices of the segments.
+ */
+struct EventFilter final {
+    std::optional<int>              iteration;
+    std::optional<ApplicationStage> stage;
+    std::optional<int>              type;
+    std::optional<TensorId>         tensor;
+    std::optional<OperatorId>       op;
+};  // struct EventFilter
+
+/**
+ * EventIndex
+ * Rows of a segment grouped by the value of a column.
+ * The index is built lazily on query and extended with the rows appended since the last query, hence appending is not slowed down.
+ */
+struct EventIndex final {
+    std::unordered_map<size_t, std::vector<size_t>> rows;
+    size_t indexed = 0;
+
+    template <typename Column>
+    const std::vector<size_t>& locate(const Column& column, size_t key) {
+        static const std::vector<size_t> empty_rows;
+        for (; indexed < column.size(); ++indexed) rows[column[indexed]].push_back(indexed);
+        auto p = rows.find(key);
+        if (p == rows.end()) return empty_rows;
+        return p->second;
+    }
+};  // struct EventIndex
+
+/**
+ * EventSegment
+ * Events of one iteration, stored in parallel columns.
+ * Appending only touches the columns, and the columns are reserved with the size of the previous iteration, hence steady-state appending requires no allocation.
+ */
+template <typename T>
+struct EventSegment;
+
+template <>
+struct EventSegment<MemoryEvent> final {
+    std::vector<OperatorId>       ops;
+    std::vector<TensorId>         tensors;
+    std::vector<size_t>           sizes;
+    std::vector<MemoryEventType>  types;
+    std::vector<ApplicationStage> stages;
+    std::vector<std::chrono::steady_clock::time_point> timestamps;
+    std::vector<long>             stalls;
+
+    mutable EventIndex tensor_index;
+    mutable EventIndex op_index;
+
+    void reserve(size_t capacity) {
+        ops.reserve(capacity);
+        tensors.reserve(capacity);
+        sizes.reserve(capacity);
+        types.reserve(capacity);
+        stages.reserve(capacity);
+        timestamps.reserve(capacity);
+        stalls.reserve(capacity);
+    }
+
+    void append(const MemoryEvent& event) {
+        ops.push_back(event.op);
+        tensors.push_back(event.tensor);
+        sizes.push_back(event.size);
+        types.push_back(event.type);
+        stages.push_back(event.stage);
+        timestamps.push_back(event.timestamp);
+        stalls.push_back(event.stall);
+    }
+
+    inline MemoryEvent at(size_t index) const { return MemoryEvent(ops[index], tensors[index], sizes[index], types[index], stages[index], timestamps[index], stalls[index]); }
+    inline size_t size() const noexcept { return ops.size(); }
+
+    /**
+     * Rows selected by the indexed conditions of the filter, or nullptr if no indexed condition.
+     */
+    const std::vector<size_t>* locate(const EventFilter& filter) const {
+        if (filter.tensor) return &tensor_index.locate(tensors, *filter.tensor);
+        if (filter.op) return &op_index.locate(ops, *filter.op);
+        return nullptr;
+    }
+
+    bool matches(size_t index, const EventFilter& filter) const {
+        if (filter.stage  && stages[index] != *filter.stage) return false;
+        if (filter.type   && static_cast<int>(types[index]) != *filter.type) return false;
+        if (filter.tensor && tensors[index] != *filter.tensor) return false;
+        if (filter.op     && ops[index] != *filter.op) return false;
+        return true;
+    }
+};  // struct EventSegment<MemoryEvent>
+
+template <>
+struct EventSegment<ExecutionEvent> final {
+    std::vector<OperatorId>         ops;
+    std::vector<ExecutionEventType> types;
+    std::vector<ApplicationStage>   stages;
+    std::vector<std::chrono::steady_clock::time_point> timestamps;
+
+    mutable EventIndex op_index;
+
+    void reserve(size_t capacity) {
+        ops.reserve(capacity);
+        types.reserve(capacity);
+        stages.reserve(capacity);
+        timestamps.reserve(capacity);
+    }
+
+    void append(const ExecutionEvent& event) {
+        ops.push_back(event.op);
+        types.push_back(event.type);
+        stages.push_back(event.stage);
+        timestamps.push_back(event.timestamp);
+    }
+
+    inline ExecutionEvent at(size_t index) const { return ExecutionEvent(ops[index], types[index], stages[index], timestamps[index]); }
+    inline size_t size() const noexcept { return ops.size(); }
+
+    const std::vector<size_t>* locate(const EventFilter& filter) const {
+        assert(!filter.tensor);
+        if (filter.op) return &op_index.locate(ops, *filter.op);
+        return nullptr;
+    }
+
+    bool matches(size_t index, const EventFilter& filter) const {
+        if (filter.stage && stages[index] != *filter.stage) return false;
+        if (filter.type  && static_cast<int>(types[index]) != *filter.type) return false;
+        if (filter.op    && ops[index] != *filter.op) return false;
+        return true;
+    }
+};  // struct EventSegment<ExecutionEvent>
+
+/**
+ * EventRing
+ * Bounded lock-free ring of events, with a single producer and a single consumer.
+ * Pushing costs a copy of the event and a release store.
+ */
+struct EventRing final {
+public:
+    using Record = std::variant<MemoryEvent, ExecutionEvent>;
+    static constexpr size_t capacity = 4096;
+
+private:
+    std::array<Record, capacity> records;
+    // Position of the next record to be drained, written by the consumer.
+    alignas(64) std::atomic<size_t> head = 0;
+    // Position of the next record to be pushed, written by the producer.
+    alignas(64) std::atomic<size_t> tail = 0;
+
+public:
+    /**
+     * Push a record on the producer thread.
+     * @return false if the ring is full
+     */
+    bool push(const Record& record) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (t - head.load(std::memory_order_acquire) == capacity) return false;
+        records[t % capacity] = record;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    static inline std::chrono::steady_clock::time_point getTimestamp(const Record& record) {
+        return std::visit([](const auto& event) { return event.timestamp; }, record);
+    }
+
+    /**
+     * Drain the records pushed so far to the rings on the consumer thread, merged in the order of timestamps.
+     * Records of the same ring are drained in the order pushed.
+     * @return count of records drained
+     */
+    template <typename Func>
+    static size_t drain(const std::vector<EventRing*>& rings, Func&& func) {
+        std::vector<size_t> heads, tails;
+        for (auto ring : rings) {
+            heads.push_back(ring->head.load(std::memory_order_relaxed));
+            tails.push_back(ring->tail.load(std::memory_order_acquire));
+        }
+
+        size_t re = 0;
+        while (true) {
+            size_t n = rings.size();
+            for (size_t i = 0; i < rings.size(); ++i) {
+                if (heads[i] == tails[i]) continue;
+                if (n == rings.size() || getTimestamp(rings[i]->records[heads[i] % capacity]) < getTimestamp(rings[n]->records[heads[n] % capacity])) n = i;
+            }
+            if (n == rings.size()) break;
+            func(rings[n]->records[heads[n] % capacity]);
+            // Release the slot to the producer.
+            rings[n]->head.store(++heads[n], std::memory_order_release);
+            ++re;
+        }
+        return re;
+    }
+
+    inline bool empty() const noexcept { return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire); }
+};  // struct EventRing
+
 template <typename T>
 struct EventSet;
 
@@ -23,26 +232,79 @@ private:
 
 private:
     int iteration = 0;
-    // key: iteration, value: MemoryEvent / ExecutionEvent
-    std::multimap<int, MemoryEvent> memory_events;
-    std::multimap<int, ExecutionEvent> execution_events;
+    // key: iteration, value: events of the iteration
+    std::map<int, EventSegment<MemoryEvent>>    memory_events;
+    std::map<int, EventSegment<ExecutionEvent>> execution_events;
+
+    // Segments of the current iteration. Map nodes are stable, hence the pointers are valid until the segments are removed.
+    EventSegment<MemoryEvent>*    current_memory_events    = nullptr;
+    EventSegment<ExecutionEvent>* current_execution_events = nullptr;
+
+    // Count of the latest iterations retained, including the current one. 0 retains all the iterations.
+    size_t retention = 0;
+    // Iterations retained regardless of the retention window, e.g., profiling iterations.
+    std::set<int> pinned;
+
+    template <typename T>
+    static EventSegment<T>* prepareSegment(std::map<int, EventSegment<T>>& segments, int iteration) {
+        auto p = segments.find(iteration);
+        if (p != segments.end()) return &(p->second);
+        size_t capacity = segments.empty() ? 0 : segments.rbegin()->second.size();
+        p = segments.emplace(iteration, EventSegment<T>()).first;
+        p->second.reserve(capacity);
+        return &(p->second);
+    }
+
+    template <typename T>
+    void evictSegments(std::map<int, EventSegment<T>>& segments) {
+        auto p = segments.begin();
+        while (p != segments.end() && (long)p->first + (long)retention <= (long)iteration) {
+            if (pinned.count(p->first)) ++p;
+            else p = segments.erase(p);
+        }
+    }
+
+    void prepareSegments() {
+        current_memory_events    = prepareSegment(memory_events, iteration);
+        current_execution_events = prepareSegment(execution_events, iteration);
+        if (retention == 0) return;
+        evictSegments(memory_events);
+        evictSegments(execution_events);
+    }
 
 public:
-    Events() = default;
+    Events() { prepareSegments(); }
+    Events(const Events&) = delete;
 
     void submitEvent(const MemoryEvent& event) {
-        memory_events.emplace(iteration, event);
+        current_memory_events->append(event);
     }
     void submitEvent(const ExecutionEvent& event) {
-        execution_events.emplace(iteration, event);
+        current_execution_events->append(event);
     }
 
     EventSet<MemoryEvent> from_memory_events() const;
     EventSet<ExecutionEvent> from_execution_events() const;
 
+    /**
+     * Retain the latest iterations and the pinned iterations only. Eviction takes place when the iteration changes.
+     * @param window count of the latest iterations retained, 0 retains all the iterations
+     * @param pinned_iterations iterations retained regardless of the window
+     */
+    void setRetention(size_t window, const std::set<int>& pinned_iterations) {
+        retention = window;
+        pinned = pinned_iterations;
+    }
+
     int getIteration() const noexcept { return iteration; }
-    void setIteration(int _iteration) noexcept { iteration = _iteration; }
-    void newIteration() noexcept { ++iteration; }
+    void setIteration(int _iteration) {
+        iteration = _iteration;
+        prepareSegments();
+    }
+    void newIteration() {
+        ++iteration;
+        prepareSegments();
+    }
 
     ~Events() = default;
 
@@ -54,28 +316,103 @@ private:
     friend Events;
 
 private:
-    using event_base = std::multimap<int, T>;
-    using event_iter = typename event_base::const_iterator;
-
-    struct Comparator final {
-        bool operator()(const event_iter& p, const event_iter& q) const {
-            if (p->first == q->first) return p->second.timestamp < q->second.timestamp;
-            return p->first < q->first;
-        }
-    };  // struct Comparator
+    using event_base = std::map<int, EventSegment<T>>;
 
 public:
     using item = std::pair<int, T>;
     using pred = std::function<bool(const item&)>;
-    using res  = std::set<event_iter, Comparator>;
+
+    /**
+     * Reference to an event row in a segment. The event is materialized from the columns on access.
+     */
+    struct ItemRef final {
+        struct Arrow final {
+            item value;
+            inline const item* operator->() const noexcept { return &value; }
+        };  // struct Arrow
+
+        int iteration;
+        const EventSegment<T>* segment;
+        size_t index;
+
+        inline item operator*() const { return item(iteration, segment->at(index)); }
+        inline Arrow operator->() const { return Arrow{**this}; }
+
+        inline bool operator<(const ItemRef& ref) const noexcept {
+            if (iteration == ref.iteration) return index < ref.index;
+            return iteration < ref.iteration;
+        }
+    };  // struct ItemRef
+
+    using res = std::vector<ItemRef>;
 
 private:
-    const event_base&                events_base;
-    std::set<event_iter, Comparator> events_cond;
-    std::vector<pred>                preds;
+    const event_base& events_base;
+    // Selected rows, in ascending order of iteration and row. Shared between the selections derived by select(), and replaced when filtered.
+    std::shared_ptr<const res> events_cond = std::make_shared<const res>();
+    std::vector<pred> preds;
+    EventFilter       filter;
 
     bool first_query = true;
 
+    bool isFiltered() const noexcept { return filter.iteration || filter.stage || filter.type || filter.tensor || filter.op; }
+
+    bool matches(const ItemRef& ref) const {
+        if (filter.iteration && ref.iteration != *filter.iteration) return false;
+        return ref.segment->matches(ref.index, filter);
+    }
+
+    void selectSegment(int iteration, const EventSegment<T>& segment, res& selected) const {
+        const std::vector<size_t>* rows = segment.locate(filter);
+        if (rows == nullptr) {
+            for (size_t i = 0; i < segment.size(); ++i) {
+                if (segment.matches(i, filter)) selected.push_back(ItemRef{iteration, &segment, i});
+            }
+        } else {
+            for (size_t i : *rows) {
+                if (segment.matches(i, filter)) selected.push_back(ItemRef{iteration, &segment, i});
+            }
+        }
+    }
+
+    void applyFilter() {
+        res selected;
+        if (first_query) {
+            assert(events_cond->empty());
+            if (filter.iteration) {
+                auto p = events_base.find(*filter.iteration);
+                if (p != events_base.end()) selectSegment(p->first, p->second, selected);
+            } else {
+                for (auto& x : events_base) selectSegment(x.first, x.second, selected);
+            }
+            first_query = false;
+        } else if (filter.iteration || filter.tensor || filter.op) {
+            // Intersect the indexed rows with the selected rows.
+            auto p = events_cond->begin();
+            while (p != events_cond->end()) {
+                int iteration = p->iteration;
+                // The rows are ordered by iteration.
+                auto q = std::partition_point(p, events_cond->end(), [iteration](const ItemRef& ref) { return ref.iteration == iteration; });
+                if (!filter.iteration || *filter.iteration == iteration) {
+                    const std::vector<size_t>* rows = p->segment->locate(filter);
+                    if (rows == nullptr || (size_t)(q - p) <= rows->size()) {
+                        for (auto r = p; r != q; ++r) if (matches(*r)) selected.push_back(*r);
+                    } else {
+                        for (size_t i : *rows) {
+                            ItemRef ref{iteration, p->segment, i};
+                            if (std::binary_search(p, q, ref) && matches(ref)) selected.push_back(ref);
+                        }
+                    }
+                }
+                p = q;
+            }
+        } else {
+            std::copy_if(events_cond->begin(), events_cond->end(), std::back_inserter(selected), [this](const ItemRef& ref) { return matches(ref); });
+        }
+        events_cond = std::make_shared<const res>(std::move(selected));
+        filter = EventFilter();
+    }
+
 private:
     EventSet(const event_base& events): events_base(events) {}
 
@@ -90,26 +427,55 @@ public:
         return *this;
     }
 
+    /**
+     * Equality conditions, resolved with the indices of the segments rather than scanning.
+     */
+    EventSet& where_iteration(int iteration) {
+        filter.iteration = iteration;
+        return *this;
+    }
+    EventSet& where_stage(ApplicationStage stage) {
+        filter.stage = stage;
+        return *this;
+    }
+    EventSet& where_type(decltype(T::type) type) {
+        filter.type = static_cast<int>(type);
+        return *this;
+    }
+    EventSet& where_tensor(TensorId tensor) {
+        static_assert(std::is_same<T, MemoryEvent>::value, "Only memory events refer tensors.");
+        filter.tensor = tensor;
+        return *this;
+    }
+    EventSet& where_operator(OperatorId op) {
+        filter.op = op;
+        return *this;
+    }
+
     EventSet& get() {
+        if (isFiltered()) applyFilter();
+
         auto p = preds.begin();
 
         if (first_query) {
-            assert(events_cond.empty());
-            auto q = events_base.begin();
-            while (q != events_base.end()) {
-                if ((*p)(*q)) events_cond.insert(q);
-                ++q;
+            assert(events_cond->empty());
+            res selected;
+            for (auto& x : events_base) {
+                for (size_t i = 0; i < x.second.size(); ++i) {
+                    ItemRef ref{x.first, &(x.second), i};
+                    if (p == preds.end() || (*p)(*ref)) selected.push_back(ref);
+                }
             }
-            ++p;
+            events_cond = std::make_shared<const res>(std::move(selected));
+            if (p != preds.end()) ++p;
             first_query = false;
         }
 
         while (p != preds.end()) {
-            auto q = events_cond.begin();
-            while (q != events_cond.end()) {
-                if ((*p)(**q)) ++q;
-                else q = events_cond.erase(q);
-            }
+            auto& f = *p;
+            res selected;
+            std::copy_if(events_cond->begin(), events_cond->end(), std::back_inserter(selected), [&f](const ItemRef& ref) { return f(*ref); });
+            events_cond = std::make_shared<const res>(std::move(selected));
             ++p;
         }
 
@@ -118,17 +484,22 @@ public:
         return *this;
     }
 
-    inline const res& ref() const noexcept { return events_cond; }
+    inline const res& ref() const noexcept { return *events_cond; }
 
     inline size_t size() const noexcept { 
-        if (first_query) return events_base.size();
-        return events_cond.size();
+        if (first_query) {
+            size_t re = 0;
+            for (auto& x : events_base) re += x.second.size();
+            return re;
+        }
+        return events_cond->size();
     }
 
-    inline bool empty() const noexcept { return events_cond.empty(); }
+    inline bool empty() const noexcept { return events_cond->empty(); }
 
     inline void clear() {
-        events_cond.clear();
+        events_cond = std::make_shared<const res>();
+        filter = EventFilter();
         first_query = true;
     }
 
@@ -151,4 +522,4 @@ inline static EventSet<T> select(const EventSet<T>& event_set) {
 }
 
 }   // namespace events
-}   // namespace mori
\ No newline at end of file
+}   // namespace mori
@@ -5,6 +5,7 @@
 #include <memory>
 
 #include "backend/dylibs_util.hpp"
+#include "backend/event_log.hpp"
 
 #include "includes/context.hpp"
 #include "includes/memory_status.hpp"
@@ -53,6 +54,9 @@ struct EventsExporter {
     std::unique_ptr<exportimpl::ExportMethod> export_method;
     void* hInst = nullptr;
 
+    // Events refer tensors and operators by handles, whose names are resolved via the memory status on export.
+    const status::MemoryStatus* status = nullptr;
+
     EventsExporter(const Context::View& context) {
         std::string export_method_name = context.at("method");
         Context::View context_view = context.view("method");
@@ -61,14 +65,65 @@ struct EventsExporter {
         else hInst = utils::load_dylib("Events Export Method", context.at("method.path"), "export_method_entry", export_method, context_view);
     }
 
+    inline void setMemoryStatus(const status::MemoryStatus& _status) { status = &_status; }
+
     virtual void onMemoryEvent(const events::MemoryEvent& event) const {}
     virtual void onExecutionEvent(const events::ExecutionEvent& event) const {}
+    virtual void onLayoutStatistics(int, const std::vector<layout::BlockStatistics>&) const {}
+    /**
+     * Action when the iteration is set, or increased if new_iteration.
+     */
+    virtual void onIteration(int, bool) const {}
 
     virtual ~EventsExporter() {
         if (hInst) dlclose(hInst);
     }
 };  // struct EventsExporter
 
+/**
+ * Export DL memory events to the binary event log, which is cheap enough to be always on.
+ * The log can be replayed offline with mori::events::EventReplayer.
+ */
+struct BinaryEventsExporter : public EventsExporter {
+protected:
+    mutable events::EventLogWriter writer;
+    mutable int iteration = 0;
+
+    void nameTensor(TensorId tensor) const {
+        if (status == nullptr || tensor == invalid_id || writer.isTensorNamed(tensor)) return;
+        // The handle may not be submitted to the backend yet. Naming is retried by the later events.
+        if (!status->isTensorRegistered(tensor)) return;
+        writer.appendName(events::eventlog::NameKind::tensor, tensor, status->getTensorName(tensor));
+    }
+
+    void nameOperator(OperatorId op) const {
+        if (status == nullptr || op == invalid_id || writer.isOperatorNamed(op)) return;
+        if (!status->isOperatorRegistered(op)) return;
+        writer.appendName(events::eventlog::NameKind::op, op, status->getOperatorName(op));
+    }
+
+public:
+    BinaryEventsExporter(const Context::View& context): EventsExporter(context) {
+        writer.open(context.at("filename"));
+    }
+
+    virtual void onMemoryEvent(const events::MemoryEvent& event) const override {
+        nameOperator(event.op);
+        nameTensor(event.tensor);
+        writer.append(iteration, event);
+    }
+    virtual void onExecutionEvent(const events::ExecutionEvent& event) const override {
+        nameOperator(event.op);
+        writer.append(iteration, event);
+    }
+    virtual void onIteration(int _iteration, bool new_iteration) const override {
+        iteration = _iteration;
+        if (new_iteration) writer.appendIteration(iteration);
+    }
+
+    virtual ~BinaryEventsExporter() = default;
+};  // struct BinaryEventsExporter
+
 struct TensorsExporter {
     std::unique_ptr<exportimpl::ExportMethod> export_method;
     void* hInst = nullptr;
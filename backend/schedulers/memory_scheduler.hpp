@@ -5,6 +5,9 @@
 #include <vector>
 #include <atomic>
 #include <mutex>
+#include <deque>
+#include <map>
+#include <limits>
 
 #include "includes/context.hpp"
 #include "includes/backend.hpp"
@@ -15,6 +18,8 @@
 #include "backend/events.hpp"
 #include "backend/decisions/layout_model.hpp"
 #include "backend/decisions/time_model.hpp"
+#include "backend/decisions/swap_model.hpp"
+#include "backend/schedulers/schedule_utils.hpp"
 
 namespace mori {
 
@@ -29,6 +34,20 @@ protected:
     std::atomic<int> current_iteration = 0;
 
 protected:
+    /**
+     * If the event is the access of the training, rather than the transferring or the waiting for it.
+     */
+    static inline bool isAccessEvent(const events::MemoryEvent& event) {
+        switch (event.type) {
+            case events::MemoryEventType::swapin:
+            case events::MemoryEventType::swapout:
+            case events::MemoryEventType::wait:
+                return false;
+            default:
+                return true;
+        }
+    }
+
     /**
      * Action when the scheduling is triggered.
     */
@@ -74,28 +93,104 @@ public:
 struct EventBasedMemoryScheduler : public MemoryScheduler {
 protected:
     bool event_decided = false;
+    // The iteration the schedule is analyzed from.
+    int  profiled_iteration = 1;
+
+    // Re-planning. When regression is measured, the schedule is withdrawn for an iteration, and rebuilt from that iteration.
+    bool   replanning = false;
+    size_t replan_window = 2;
+    double replan_stall_ratio = 0.5;
+    long   replan_stall_floor = 1000;
+    // Stalls of the recent iterations since the schedule is decided, in microseconds.
+    std::deque<long> stalls;
+    int examined_iteration = 0;
 
     virtual void preAnalyzeEvents()  = 0;
-    virtual std::unordered_set<std::string> analyzeForwardEvents(const events::EventSet<events::MemoryEvent>&)               = 0;
-    virtual void analyzeBackwardEvents(const events::EventSet<events::MemoryEvent>&, const std::unordered_set<std::string>&) = 0;
+    virtual std::unordered_set<TensorId> analyzeForwardEvents(const events::EventSet<events::MemoryEvent>&)               = 0;
+    virtual void analyzeBackwardEvents(const events::EventSet<events::MemoryEvent>&, const std::unordered_set<TensorId>&) = 0;
     virtual void postAnalyzeEvents() = 0;
 
+    /**
+     * Action when the schedule is to be rebuilt. The analysis states should be reset.
+     */
+    virtual void onReplan() {
+        schedule_events.forward_schedule_events  = events::StageScheduleEvents();
+        schedule_events.backward_schedule_events = events::StageScheduleEvents();
+    }
+
+    /**
+     * Stall of the iteration, the time not spent in operator execution between the first and the last execution event.
+     * @return stall in microseconds, -1 if the events of the iteration are not retained.
+     */
+    long getIterationStall(int iteration) const {
+        auto iter_exec_res = events.from_execution_events().where_iteration(iteration).get();
+        if (iter_exec_res.empty()) return -1;
+
+        long first = std::numeric_limits<long>::max();
+        long last  = std::numeric_limits<long>::min();
+        long busy  = 0;
+        std::map<std::pair<OperatorId, ApplicationStage>, long> request_timepoints;
+        for (auto &x : iter_exec_res.ref()) {
+            long timestamp = utils::get_timestamp_val(x->second.timestamp);
+            first = std::min(first, timestamp);
+            last  = std::max(last, timestamp);
+            auto key = std::make_pair(x->second.op, x->second.stage);
+            if (x->second.type == events::ExecutionEventType::request) request_timepoints[key] = timestamp;
+            else if (x->second.type == events::ExecutionEventType::release) {
+                auto p = request_timepoints.find(key);
+                if (p == request_timepoints.end()) continue;
+                busy += timestamp - p->second;
+                request_timepoints.erase(p);
+            }
+        }
+        return std::max(0L, last - first - busy);
+    }
+
+    /**
+     * Examine the completed iterations for regression of the schedule.
+     * Regression is measured as swapping in at forward propagation, which the schedule should have prevented, or the stall growing beyond the average of the recent iterations.
+     * The growth of the stall should exceed the floor as well, so that the jitter over a near-zero average is not taken as regression.
+     */
+    bool isRegressed() {
+        bool regressed = false;
+        int completed = events.getIteration() - 1;
+        for (int i = std::max(examined_iteration + 1, profiled_iteration + 1); i <= completed; ++i) {
+            auto iter_forward_swapin_res = events.from_memory_events().where_iteration(i).where_stage(ApplicationStage::forward).where_type(events::MemoryEventType::swapin).get();
+            if (!iter_forward_swapin_res.empty()) regressed = true;
+
+            long stall = getIterationStall(i);
+            if (stall == -1) continue;
+            if (stalls.size() == replan_window) {
+                long average = 0;
+                for (auto x : stalls) average += x;
+                average /= stalls.size();
+                if (stall > average * (1 + replan_stall_ratio) && stall - average > replan_stall_floor) regressed = true;
+                stalls.pop_front();
+            }
+            stalls.push_back(stall);
+        }
+        examined_iteration = std::max(examined_iteration, completed);
+        return regressed;
+    }
+
     virtual void onSchedule() override {
-        if (event_decided) return;
+        if (event_decided) {
+            if (!replanning || !isRegressed()) return;
+            // Swapping by the schedule submits no swap-out events, hence an iteration under the schedule does not show the deficits of memory.
+            // The next iteration runs without the schedule, and is profiled instead.
+            profiled_iteration = events.getIteration() + 1;
+            stalls.clear();
+            onReplan();
+            event_decided = false;
+            return;
+        }
 
-        auto iter_1_mem_res = events.from_memory_events().where([](const events::EventSet<events::MemoryEvent>::item& item) {
-            // return item.first == (current_iteration - 1);
-            return item.first == 1;
-        }).get();
+        // auto iter_1_mem_res = events.from_memory_events().where_iteration(current_iteration - 1).get();
+        auto iter_1_mem_res = events.from_memory_events().where_iteration(profiled_iteration).get();
         if (iter_1_mem_res.empty()) return;
 
-        auto iter_1_forward_mem_res = iter_1_mem_res.select().where([](const events::EventSet<events::MemoryEvent>::item& item) {
-            return item.second.stage == ApplicationStage::forward;
-        }).get();
-
-        auto iter_1_backward_mem_res = iter_1_mem_res.select().where([](const events::EventSet<events::MemoryEvent>::item& item) {
-            return item.second.stage == ApplicationStage::backward;
-        }).get();
+        auto iter_1_forward_mem_res  = iter_1_mem_res.select().where_stage(ApplicationStage::forward).get();
+        auto iter_1_backward_mem_res = iter_1_mem_res.select().where_stage(ApplicationStage::backward).get();
 
         preAnalyzeEvents();
         auto tensors_swapped = analyzeForwardEvents(iter_1_forward_mem_res);
@@ -117,44 +212,105 @@ protected:
     virtual void onMemoryEvent(const events::ExecutionEvent& event) override {}
     virtual void onNewIteration() override {}
 public:
-    EventBasedMemoryScheduler(const Context::View& _context, status::MemoryStatus& _status, events::Events& _events): MemoryScheduler(_context, _status, _events) {}
+    EventBasedMemoryScheduler(const Context::View& _context, status::MemoryStatus& _status, events::Events& _events): MemoryScheduler(_context, _status, _events) {
+        replanning         = context.signal("replan");
+        replan_window      = std::max(1UL, std::stoul(context.at("replan.window")));
+        replan_stall_ratio = std::stod(context.at("replan.stall"));
+        replan_stall_floor = std::stol(context.at("replan.stall.floor"));
+    }
     virtual ~EventBasedMemoryScheduler() = default;
 };  // struct EventBasedMemoryScheduler
 
 struct FIFOMemoryScheduler : public EventBasedMemoryScheduler {
 protected:
+    struct SwapCandidate final {
+        TensorId   tensor        = invalid_id;
+        OperatorId last_acquired = invalid_id;
+        size_t     size          = 0;
+
+        SwapCandidate(TensorId _tensor, OperatorId _last_acquired, size_t _size): tensor(_tensor), last_acquired(_last_acquired), size(_size) {}
+    };  // inner struct SwapCandidate
+
+    decisions::TransferringModel transferring_model;
+
+protected:
+    /**
+     * selectVictims
+     * Select the candidates to swap out, covering the deficits of memory in forward propagation with the minimal transferring weighted by the idle time.
+     * The deficits are measured by the data passively swapped out in the profiled iteration.
+     * @return tensors to swap out
+     */
+    std::unordered_set<TensorId> selectVictims(const events::EventSet<events::MemoryEvent>& iter_1_forward_mem_res, const std::vector<SwapCandidate>& candidates) {
+        std::vector<std::string> forward_order = status.getForwardExecutionOrder().toVector();
+        std::unordered_map<OperatorId, size_t> positions;
+        for (size_t i = 0; i < forward_order.size(); ++i) positions.emplace(status.getOperatorId(forward_order[i]), i);
+
+        // Memory released passively till each operator, and the last access of the tensors.
+        std::vector<size_t> deficits(forward_order.size(), 0);
+        std::unordered_map<TensorId, long> acquired_timepoints;
+        size_t posi = 0;
+        for (auto &x : iter_1_forward_mem_res.ref()) {
+            auto p = positions.find(x->second.op);
+            if (p != positions.end()) posi = p->second;
+            if (x->second.type == events::MemoryEventType::swapout && posi < deficits.size()) deficits[posi] += x->second.size;
+            if (isAccessEvent(x->second)) acquired_timepoints[x->second.tensor] = utils::get_timestamp_val(x->second.timestamp);
+        }
+        for (size_t i = 1; i < deficits.size(); ++i) deficits[i] += deficits[i - 1];
+
+        // The first access of the tensors in backward propagation.
+        auto iter_1_backward_mem_res = events.from_memory_events().where_iteration(profiled_iteration).where_stage(ApplicationStage::backward).get();
+        std::unordered_map<TensorId, long> accessed_timepoints;
+        for (auto &x : iter_1_backward_mem_res.ref()) {
+            if (!isAccessEvent(x->second)) continue;
+            accessed_timepoints.emplace(x->second.tensor, utils::get_timestamp_val(x->second.timestamp));
+        }
+
+        utils::VictimSelector selector;
+        for (auto &x : candidates) {
+            auto p = positions.find(x.last_acquired);
+            size_t released = p == positions.end() ? 0 : p->second + 1;
+            // Not accessed in backward propagation, hence the transferring is never exposed.
+            long idle = std::numeric_limits<long>::max() / 2;
+            auto q = accessed_timepoints.find(x.tensor);
+            auto r = acquired_timepoints.find(x.tensor);
+            if (q != accessed_timepoints.end() && r != acquired_timepoints.end()) idle = q->second - r->second;
+            selector.submitVictim(utils::VictimSelector::Victim(x.size, transferring_model.analyze(x.size), idle, released));
+        }
+        selector.setDeficits(deficits);
+        selector.select();
+
+        std::unordered_set<TensorId> re;
+        for (size_t n = 0; n < candidates.size(); ++n) {
+            if (selector.isSelected(n)) re.insert(candidates[n].tensor);
+        }
+        return re;
+    }
+
     virtual void preAnalyzeEvents() override  {}
-    virtual std::unordered_set<std::string> analyzeForwardEvents(const events::EventSet<events::MemoryEvent>& iter_1_forward_mem_res) override {
-        auto iter_1_forward_swapout_res = iter_1_forward_mem_res.select().where([](const events::EventSet<events::MemoryEvent>::item& item) {
-            return item.second.type == events::MemoryEventType::swapout;
-        }).get();
+    virtual std::unordered_set<TensorId> analyzeForwardEvents(const events::EventSet<events::MemoryEvent>& iter_1_forward_mem_res) override {
+        auto iter_1_forward_swapout_res = iter_1_forward_mem_res.select().where_type(events::MemoryEventType::swapout).get();
         // No need to swap.
-        if (iter_1_forward_swapout_res.empty()) return std::unordered_set<std::string>();
+        if (iter_1_forward_swapout_res.empty()) return std::unordered_set<TensorId>();
 
-        size_t unmet_memory_requirement = 0;
-        size_t released_memory_requirement = 0;
-        for (auto &x : iter_1_forward_swapout_res.ref()) unmet_memory_requirement += x->second.size;
-
-        std::unordered_set<std::string> tensors_swapped;
+        std::vector<SwapCandidate> candidates;
         // Tensors to swapout.
-        for (auto &s : status.getExecutionOrder()) {
-            status::OperatorPres op_pres = status.referenceOperator(s);
-            // Forward propagation and backward propagation share the same set of operators.
-            if (op_pres.isBackwardPropagation()) continue;
+        // Forward propagation and backward propagation share the same set of operators.
+        for (auto &s : status.getForwardExecutionOrder()) {
+            status::ConstOperatorPres op_pres = status.referenceConstOperator(s);
 
             for (auto &tensor_name : op_pres.getTensors()) { 
-                status::TensorPres tensor_pres = status.referenceTensor(tensor_name);
+                status::ConstTensorPres tensor_pres = status.referenceConstTensor(tensor_name);
                 // Do not swap out persistant tensors.
                 if (tensor_pres.isPersistent() || tensor_pres.isTransient()) continue;
 
                 // Get the last access of this tensor in forward stage.
-                auto iter_1_tensor_forward_res = iter_1_forward_mem_res.select().where([&tensor_name](const events::EventSet<events::MemoryEvent>::item& item) {
-                    return item.second.tensor == tensor_name && item.second.type != events::MemoryEventType::swapin && item.second.type != events::MemoryEventType::swapout;
+                TensorId tensor = tensor_pres.getId();
+                auto iter_1_tensor_forward_res = iter_1_forward_mem_res.select().where_tensor(tensor).where([](const events::EventSet<events::MemoryEvent>::item& item) {
+                    return isAccessEvent(item.second);
                 }).get();
 
                 bool forward_event_generated = false;
-                std::string last_acquired;
-                std::string last_assigned;
+                OperatorId last_acquired = invalid_id;
                 for (auto &y : iter_1_tensor_forward_res.ref()) {
                     switch (y->second.type) {
                         case events::MemoryEventType::allocate:
@@ -163,10 +319,6 @@ protected:
                         case events::MemoryEventType::read:
                             last_acquired = y->second.op;
                             break;
-                        case events::MemoryEventType::write:
-                        case events::MemoryEventType::access:
-                            last_assigned = y->second.op;
-                            break;
                         case events::MemoryEventType::free:
                             // Tensor released in forward propagation, swapout event should not be generated.
                             forward_event_generated = false;
@@ -176,17 +328,20 @@ protected:
                 }
 
                 if (!forward_event_generated) continue;
-
-                tensors_swapped.insert(tensor_name);
-                // Generate swapout event
-                // schedule_events.forward_schedule_events.execution[last_assigned].emplace_back(tensor_pres.getOperatorName(), tensor_pres.getName(), tensor_pres.getSize(), events::ScheduleEventType::copyout, last_assigned);
-                schedule_events.forward_schedule_events.execution[last_acquired].emplace_back(tensor_pres.getOperatorName(), tensor_pres.getName(), tensor_pres.getSize(), events::ScheduleEventType::swapout, last_acquired);
-                released_memory_requirement += tensor_pres.getSize();
-
-                // if (unmet_memory_requirement <= released_memory_requirement) break;
+                candidates.emplace_back(tensor, last_acquired, tensor_pres.getSize());
             }
         }
 
+        std::unordered_set<TensorId> tensors_swapped = selectVictims(iter_1_forward_mem_res, candidates);
+        for (auto &x : candidates) {
+            if (tensors_swapped.find(x.tensor) == tensors_swapped.end()) continue;
+            status::ConstTensorPres tensor_pres = status.referenceConstTensor(x.tensor);
+            // Generate swapout event
+            const std::string& last_acquired_name = status.getOperatorName(x.last_acquired);
+            // schedule_events.forward_schedule_events.execution[last_assigned_name].emplace_back(tensor_pres.getOperatorName(), tensor_pres.getName(), tensor_pres.getSize(), events::ScheduleEventType::copyout, last_assigned_name);
+            schedule_events.forward_schedule_events.execution[last_acquired_name].emplace_back(tensor_pres.getOperatorName(), tensor_pres.getName(), tensor_pres.getSize(), events::ScheduleEventType::swapout, last_acquired_name);
+        }
+
         return tensors_swapped;
     }
     virtual void postAnalyzeEvents() override {}
@@ -198,45 +353,47 @@ public:
 struct ExecutionTimeAwareMemoryScheduler : public FIFOMemoryScheduler {
 protected:
     decisions::TimeModel         time_model;
-    decisions::TransferringModel transferring_model;
 
+    // Execution timespans of operators in microseconds.
     std::unordered_map<std::string, long> execution_timespans;
 
 protected:
     virtual void preAnalyzeEvents() override {
-        auto iter_1_backward_res = events.from_execution_events().where([](const events::EventSet<events::ExecutionEvent>::item& item) {
-            // return item.first == (current_iteration - 1);
-            return item.first == 1 && item.second.stage == ApplicationStage::backward;
-        }).get();
+        // auto iter_1_backward_res = events.from_execution_events().where_iteration(current_iteration - 1).where_stage(ApplicationStage::backward).get();
+        auto iter_1_backward_res = events.from_execution_events().where_iteration(profiled_iteration).where_stage(ApplicationStage::backward).get();
         // No memory events.
         if (iter_1_backward_res.empty()) return;
 
-        auto iter_1_backward_request_res = iter_1_backward_res.select().where([](const events::EventSet<events::ExecutionEvent>::item& item) {
-            return item.second.type == events::ExecutionEventType::request;
-        }).get();
-        auto iter_1_backward_release_res = iter_1_backward_res.select().where([](const events::EventSet<events::ExecutionEvent>::item& item) {
-            return item.second.type == events::ExecutionEventType::release;
-        }).get();
+        auto iter_1_backward_request_res = iter_1_backward_res.select().where_type(events::ExecutionEventType::request).get();
+        auto iter_1_backward_release_res = iter_1_backward_res.select().where_type(events::ExecutionEventType::release).get();
 
-        std::unordered_map<std::string, long> request_timepoints;
-        std::unordered_map<std::string, long> release_timepoints;
+        std::unordered_map<OperatorId, long> request_timepoints;
+        std::unordered_map<OperatorId, long> release_timepoints;
 
         for (auto &x : iter_1_backward_request_res.ref()) request_timepoints[x->second.op] = utils::get_timestamp_val(x->second.timestamp);
         for (auto &x : iter_1_backward_release_res.ref()) release_timepoints[x->second.op] = utils::get_timestamp_val(x->second.timestamp);
         assert(request_timepoints.size() == release_timepoints.size());
 
-        for (auto &s : status.getExecutionOrder()) {
-            status::OperatorPres operator_pres = status.referenceOperator(s);
-            if (!operator_pres.isBackwardPropagation()) continue;
-            if (request_timepoints.count(s) != 1 || release_timepoints.count(s) != 1) continue;
+        for (auto &s : status.getBackwardExecutionOrder()) {
+            status::ConstOperatorPres operator_pres = status.referenceConstOperator(s);
+            OperatorId op = operator_pres.getId();
+            if (request_timepoints.count(op) != 1 || release_timepoints.count(op) != 1) continue;
             
-            execution_timespans.emplace(s, release_timepoints.at(s) - request_timepoints.at(s));
-            decisions::TimeModel::Timespan timespan(s, release_timepoints.at(s) - request_timepoints.at(s));
+            execution_timespans.emplace(s, release_timepoints.at(op) - request_timepoints.at(op));
+            decisions::TimeModel::Timespan timespan(s, release_timepoints.at(op) - request_timepoints.at(op));
             time_model.submitExecutionSynchronization(s);
             time_model.submitExecutionTimespan(s, timespan);
         }
     }
 
+    virtual void onReplan() override {
+        FIFOMemoryScheduler::onReplan();
+        execution_timespans.clear();
+        bool strong_synchronization = time_model.isStrongSynchronization();
+        time_model = decisions::TimeModel();
+        time_model.setStrongSynchronization(strong_synchronization);
+    }
+
 public:
     ExecutionTimeAwareMemoryScheduler(const Context::View& _context, status::MemoryStatus& _status, events::Events& _events): FIFOMemoryScheduler(_context, _status, _events) { time_model.setStrongSynchronization(false); }
     virtual ~ExecutionTimeAwareMemoryScheduler() = default;
@@ -263,19 +420,14 @@ protected:
         ExecutionTimeAwareMemoryScheduler::preAnalyzeEvents();
     }
 
-    virtual std::unordered_set<std::string> analyzeForwardEvents(const events::EventSet<events::MemoryEvent>& iter_1_forward_mem_res) override {
-        std::unordered_set<std::string> tensors_swapped;
+    virtual std::unordered_set<TensorId> analyzeForwardEvents(const events::EventSet<events::MemoryEvent>& iter_1_forward_mem_res) override {
+        std::unordered_set<TensorId> tensors_swapped;
 
-        auto iter_1_forward_swapout_res = iter_1_forward_mem_res.select().where([](const events::EventSet<events::MemoryEvent>::item& item) {
-            return item.second.type == events::MemoryEventType::swapout;
-        }).get();
+        auto iter_1_forward_swapout_res = iter_1_forward_mem_res.select().where_type(events::MemoryEventType::swapout).get();
         // No need to swap.
         if (iter_1_forward_swapout_res.empty()) return tensors_swapped;
 
-        size_t unmet_memory_requirement = 0;
-        size_t released_memory_requirement = 0;
-        for (auto &x : iter_1_forward_swapout_res.ref()) unmet_memory_requirement += x->second.size;
-
+        std::vector<SwapCandidate> candidates;
         // Generate swapout events based on analysis model.
         // All tensors are accessed in forward propagation.
         
@@ -285,13 +437,11 @@ protected:
                 if (node.posts.empty()) continue;   // No need to swapout tensor.
                 
                 // Generate copyout and freehost events.
-                auto iter_1_tensor_forward_res = iter_1_forward_mem_res.select().where([s](const events::EventSet<events::MemoryEvent>::item& item) {
-                    return item.second.tensor == s;
-                }).get();
+                TensorId tensor = status.getTensorId(s);
+                auto iter_1_tensor_forward_res = iter_1_forward_mem_res.select().where_tensor(tensor).get();
 
                 bool forward_event_generated = false;
-                std::string last_acquired;
-                std::string last_assigned;
+                OperatorId last_acquired = invalid_id;
                 for (auto &y : iter_1_tensor_forward_res.ref()) {
                     switch (y->second.type) {
                         case events::MemoryEventType::allocate:
@@ -300,10 +450,6 @@ protected:
                         case events::MemoryEventType::read:
                             last_acquired = y->second.op;
                             break;
-                        case events::MemoryEventType::write:
-                        case events::MemoryEventType::access:
-                            last_assigned = y->second.op;
-                            break;
                         case events::MemoryEventType::free:
                             // Tensor released in forward propagation, swapout event should not be generated.
                             forward_event_generated = false;
@@ -314,39 +460,44 @@ protected:
 
                 if (!forward_event_generated) continue;
 
-                tensors_swapped.insert(s);
-                status::TensorPres pres = status.referenceTensor(s);
-                for (auto &x : node.region.sections) {
-                    // schedule_events.forward_schedule_events.execution[last_assigned].emplace_back(pres.getOperatorName(), s, x, events::ScheduleEventType::copyout, last_acquired);
-                    schedule_events.forward_schedule_events.execution[last_acquired].emplace_back(pres.getOperatorName(), s, x, events::ScheduleEventType::swapout, last_acquired);
-                    released_memory_requirement += x;
-                }
+                size_t size = 0;
+                for (auto &x : node.region.sections) size += x;
+                candidates.emplace_back(tensor, last_acquired, size);
+            }
+        }
 
-                // if (unmet_memory_requirement <= released_memory_requirement) break;
+        tensors_swapped = selectVictims(iter_1_forward_mem_res, candidates);
+        for (auto &x : candidates) {
+            if (tensors_swapped.find(x.tensor) == tensors_swapped.end()) continue;
+            status::ConstTensorPres pres = status.referenceConstTensor(x.tensor);
+            const decisions::LayoutModel::Node& node = layout_model.getMemoryNode(pres.getName());
+            const std::string& last_acquired_name = status.getOperatorName(x.last_acquired);
+            for (auto &y : node.region.sections) {
+                // schedule_events.forward_schedule_events.execution[last_assigned_name].emplace_back(pres.getOperatorName(), pres.getName(), y, events::ScheduleEventType::copyout, last_acquired_name);
+                schedule_events.forward_schedule_events.execution[last_acquired_name].emplace_back(pres.getOperatorName(), pres.getName(), y, events::ScheduleEventType::swapout, last_acquired_name);
             }
         }
         return tensors_swapped;
     }
-    virtual void analyzeBackwardEvents(const events::EventSet<events::MemoryEvent>& iter_1_backward_mem_res, const std::unordered_set<std::string>& tensors_swapped) override {
+    virtual void analyzeBackwardEvents(const events::EventSet<events::MemoryEvent>& iter_1_backward_mem_res, const std::unordered_set<TensorId>& tensors_swapped) override {
         auto iter_1_backward_access_res = iter_1_backward_mem_res.select().where([](const events::EventSet<events::MemoryEvent>::item& item) {
             if (item.second.type == events::MemoryEventType::allocate) return false;
             if (item.second.type == events::MemoryEventType::free) return false;
-            return item.second.type != events::MemoryEventType::swapin && item.second.type != events::MemoryEventType::swapout;
+            return isAccessEvent(item.second);
         }).get();
 
-        for (auto &s : status.getExecutionOrder()) {
-            auto op_pres = status.referenceOperator(s);
-            if (!op_pres.isBackwardPropagation()) continue;
+        for (auto &s : status.getBackwardExecutionOrder()) {
+            auto op_pres = status.referenceConstOperator(s);
 
-            auto target_operator_backward_res = iter_1_backward_access_res.select().where([&s, &tensors_swapped](const events::EventSet<events::MemoryEvent>::item& item) {
-                if (item.second.op != s) return false;
+            OperatorId op = op_pres.getId();
+            auto target_operator_backward_res = iter_1_backward_access_res.select().where_operator(op).where([&tensors_swapped](const events::EventSet<events::MemoryEvent>::item& item) {
                 return tensors_swapped.find(item.second.tensor) != tensors_swapped.end();
             }).get();
             if (target_operator_backward_res.empty()) continue;
 
             for (auto &x : target_operator_backward_res.ref()) {
-                status::TensorPres tensor_pres = status.referenceTensor(x->second.tensor);
-                decisions::TimeModel::Timespan timespan(x->second.tensor, transferring_model.analyze(tensor_pres.getSize()));
+                status::ConstTensorPres tensor_pres = status.referenceConstTensor(x->second.tensor);
+                decisions::TimeModel::Timespan timespan(tensor_pres.getName(), transferring_model.analyze(tensor_pres.getSize()));
                 time_model.submitTransferringTimespan(s, timespan);
             }
             time_model.submitTransferringSynchronization(s);
@@ -357,7 +508,7 @@ protected:
 
         for (auto &x : time_model.transferring_lane.timespans) {
             if (x.second.synchronization) continue;
-            status::TensorPres pres = status.referenceTensor(x.second.target);
+            status::ConstTensorPres pres = status.referenceConstTensor(x.second.target);
             // Generate swapin event
             schedule_events.backward_schedule_events.timepoint.emplace_back(pres.getOperatorName(), pres.getName(), pres.getSize(), events::ScheduleEventType::copyin, x.second.timepoint);
         }
@@ -370,48 +521,112 @@ public:
 
 struct DependencyAwareMemoryScheduler : public ExecutionTimeAwareMemoryScheduler {
 private:
+    /**
+     * TensorRelation
+     * The prefetching of a tensor is issued after the current operator, and the data is accessed by the accessing operator.
+     * Slack is the time from the predicted completion of the prefetching to the access, measured in each iteration. Negative slack is the time the training thread stalled.
+     */
     struct TensorRelation {
         std::string current_operator = "";
-        bool        schedule_changed = false;
-        int         position         = 0;
+        std::string access_operator  = "";
+        long        transfer_time    = 0;
+
+        // Measurement of the current iteration, in microseconds.
+        long        issued_timepoint = 0;
+        bool        issued           = false;
+        bool        evicted          = false;
+        bool        measured         = false;
+        long        slack            = 0;
 
-        TensorRelation(const std::string op): current_operator(op), schedule_changed(false), position(0) {}
+        TensorRelation(const std::string& _current_operator, const std::string& _access_operator, long _transfer_time): current_operator(_current_operator), access_operator(_access_operator), transfer_time(_transfer_time) {}
     };  // inner struct TensorRelation
 
 private:
-    std::unordered_map<std::string, TensorRelation> tensor_operator_relations;
-    std::unordered_set<std::string>                 tensor_swapout_this_iter;
+    std::unordered_map<TensorId, TensorRelation> tensor_operator_relations;
 
     bool   time_aware = true;
     size_t thershold  = 2;
+    long   target_slack    = 0;
+    long   slack_tolerance = 0;
+
+protected:
+    void measureSlack(TensorRelation& relation, long accessed_timepoint) {
+        if (relation.measured || !relation.issued) return;
+        relation.slack    = accessed_timepoint - (relation.issued_timepoint + relation.transfer_time);
+        relation.measured = true;
+    }
+
+    /**
+     * Move the prefetching by the execution time equal to the slack beyond the target.
+     * Moving earlier by an operator gains its execution time. The prefetching stays in the profiled backward operators, and before the accessing operator.
+     */
+    void adjustPrefetching(TensorId tensor, TensorRelation& relation) {
+        long deviation = relation.slack - target_slack;
+        if (deviation < 0 && deviation >= -slack_tolerance) return;
+        std::string opb = relation.current_operator;
+        if (deviation < 0) {
+            while (deviation < 0 && status.hasExecutionPrev(opb)) {
+                std::string prev = status.getExecutionPrev(opb);
+                if (execution_timespans.count(opb) == 0 || execution_timespans.count(prev) == 0) break;
+                deviation += execution_timespans.at(opb);
+                opb = prev;
+            }
+        } else {
+            // The completion of the prefetching is predicted, hence moving later is damped to avoid overshooting into stall.
+            deviation /= 2;
+            while (status.hasExecutionPost(opb)) {
+                std::string post = status.getExecutionPost(opb);
+                if (post == relation.access_operator || execution_timespans.count(post) == 0) break;
+                if (execution_timespans.at(post) > deviation) break;
+                deviation -= execution_timespans.at(post);
+                opb = post;
+            }
+        }
+        if (opb == relation.current_operator) return;
+
+        auto& schedule_events_set = schedule_events.backward_schedule_events.execution;
+        auto& current_events = schedule_events_set[relation.current_operator];
+        std::string tensor_name = status.getTensorName(tensor);
+        auto q = std::find_if(current_events.begin(), current_events.end(), [&tensor_name](const events::ScheduleEvent& _event) {
+            return _event.tensor_name == tensor_name;
+        });
+        // The prefetching may be missing from the schedule, e.g. removed by a replan.
+        if (q == current_events.end()) return;
+
+        events::ScheduleEvent new_event = *q;
+        new_event.operator_name = opb;
+        current_events.erase(q);
+        schedule_events_set[opb].push_back(new_event);
+        relation.current_operator = opb;
+    }
 
 public:
     DependencyAwareMemoryScheduler(const Context::View& _context, status::MemoryStatus& _status, events::Events& _events): ExecutionTimeAwareMemoryScheduler(_context, _status, _events) {
-        time_aware = context.signal("dependency.timeaware");
-        thershold  = std::stoul(context.at("dependency.thershold"));
+        time_aware      = context.signal("dependency.timeaware");
+        thershold       = std::stoul(context.at("dependency.thershold"));
+        target_slack    = std::stol(context.at("dependency.slack"));
+        slack_tolerance = std::stol(context.at("dependency.slack.tolerance"));
     }
 
-    virtual void analyzeBackwardEvents(const events::EventSet<events::MemoryEvent>& iter_1_backward_mem_res, const std::unordered_set<std::string>& tensors_swapped) override {
+    virtual void analyzeBackwardEvents(const events::EventSet<events::MemoryEvent>& iter_1_backward_mem_res, const std::unordered_set<TensorId>& tensors_swapped) override {
         auto iter_1_backward_access_res = iter_1_backward_mem_res.select().where([](const events::EventSet<events::MemoryEvent>::item& item) {
             if (item.second.type == events::MemoryEventType::allocate) return false;
             if (item.second.type == events::MemoryEventType::free) return false;
-            return item.second.type != events::MemoryEventType::swapin && item.second.type != events::MemoryEventType::swapout;
+            return isAccessEvent(item.second);
         }).get();
 
         // Generate swap events.
         for (auto &x : tensors_swapped) {
             // Get the first access of this tensor in backword stage
-            auto target_tensor_backward_res = iter_1_backward_access_res.select().where([&x](const events::EventSet<events::MemoryEvent>::item& item) {
-                return item.second.tensor == x;
-            }).get();
+            auto target_tensor_backward_res = iter_1_backward_access_res.select().where_tensor(x).get();
 
             if (target_tensor_backward_res.ref().empty()) continue;
 
-            status::TensorPres pres = status.referenceTensor(x);
-            std::string opb = (*target_tensor_backward_res.ref().begin())->second.op;
+            status::ConstTensorPres pres = status.referenceConstTensor(x);
+            std::string opb = status.getOperatorName((*target_tensor_backward_res.ref().begin())->second.op);
             size_t execution_time = 0;
             size_t transfer_time  = transferring_model.analyze(pres.getSize());
-            for (int i = 0; i < thershold + 1; ++i) {
+            for (size_t i = 0; i < thershold + 1; ++i) {
                 if (!status.hasExecutionPrev(opb)) break;
                 opb = status.getExecutionPrev(opb);
                 assert(opb != "");
@@ -423,63 +638,303 @@ public:
             assert(opb != "");
             // Generate swapin event
             schedule_events.backward_schedule_events.execution[opb].emplace_back(pres.getOperatorName(), pres.getName(), pres.getSize(), events::ScheduleEventType::copyin, opb);
-            tensor_operator_relations.emplace(pres.getName(), opb);
+            tensor_operator_relations.emplace(x, TensorRelation(opb, status.getOperatorName((*target_tensor_backward_res.ref().begin())->second.op), transfer_time));
         }
     }
     virtual void onMemoryEvent(const events::MemoryEvent& event) override {
         FIFOMemoryScheduler::onMemoryEvent(event);
 
-        if (!time_aware) return;
+        if (!time_aware || !event_decided) return;
+        if (event.stage != ApplicationStage::backward) return;
+
+        auto p = tensor_operator_relations.find(event.tensor);
+        if (p == tensor_operator_relations.end()) return;
+        TensorRelation& relation = p->second;
+
+        switch (event.type) {
+            case events::MemoryEventType::swapout:
+                // Prefetched too early, and swapped out before accessed.
+                if (relation.issued) relation.evicted = true;
+                break;
+            case events::MemoryEventType::swapin:
+            case events::MemoryEventType::wait:
+                // Swapped in by the training, or waited for the prefetching in flight.
+                if (relation.measured) break;
+                // The data was required when the waiting started.
+                if (relation.evicted) measureSlack(relation, utils::get_timestamp_val(event.timestamp) - event.stall);
+                else {
+                    relation.slack    = -event.stall;
+                    relation.measured = true;
+                }
+                break;
+            default:
+                break;
+        }
+    }
+    virtual void onMemoryEvent(const events::ExecutionEvent& event) override {
+        if (!time_aware || !event_decided) return;
+        if (event.stage != ApplicationStage::backward) return;
+
+        const std::string& op_name = status.getOperatorName(event.op);
+        long timestamp = utils::get_timestamp_val(event.timestamp);
+        for (auto &x : tensor_operator_relations) {
+            TensorRelation& relation = x.second;
+            if (event.type == events::ExecutionEventType::release && relation.current_operator == op_name) {
+                relation.issued_timepoint = timestamp;
+                relation.issued = true;
+            }
+            // The request is submitted after the waiting, hence no stall if not measured yet.
+            if (event.type == events::ExecutionEventType::request && relation.access_operator == op_name) measureSlack(relation, timestamp);
+        }
+    }
+    virtual void onNewIteration() override {
+        if (!time_aware || !event_decided) return;
+
+        schedule_events.slacks.clear();
+        for (auto &x : tensor_operator_relations) {
+            TensorRelation& relation = x.second;
+            if (relation.measured) {
+                schedule_events.slacks[status.getTensorName(x.first)] = relation.slack;
+                adjustPrefetching(x.first, relation);
+            }
+            relation.issued   = false;
+            relation.evicted  = false;
+            relation.measured = false;
+        }
+    }
+    virtual void onReplan() override {
+        ExecutionTimeAwareMemoryScheduler::onReplan();
+        tensor_operator_relations.clear();
+        schedule_events.slacks.clear();
+    }
+
+    virtual ~DependencyAwareMemoryScheduler() = default;
 
-        if (event.stage == ApplicationStage::backward && (event.type == events::MemoryEventType::swapin || event.type == events::MemoryEventType::swapout)) {
-            // Indicate swapping in too late or too early
-            auto p = tensor_operator_relations.find(event.tensor);
-            if (p == tensor_operator_relations.end()) return;
+};  // struct DependencyAwareMemoryScheduler
 
-            // Indicate schedule already adjusted with no benefits
-            if (p->second.position == 0 && p->second.schedule_changed) return;
+/**
+ * RecomputationAwareMemoryScheduler
+ * Decide per tensor between swapping and recomputation. Tensors whose producer operator executes faster than the round trip of transferring are dropped, and recomputed by the framework when accessed.
+ */
+struct RecomputationAwareMemoryScheduler : public DependencyAwareMemoryScheduler {
+protected:
+    // Forward execution timespans of operators in microseconds, the cost of re-running the producers.
+    std::unordered_map<std::string, long> forward_timespans;
 
-            // Indicate this tensor is swapped in after swapped out in backward propagation
-            if (tensor_swapout_this_iter.find(event.tensor) != tensor_swapout_this_iter.end()) return;
+protected:
+    virtual void preAnalyzeEvents() override {
+        DependencyAwareMemoryScheduler::preAnalyzeEvents();
+
+        auto iter_1_forward_res = events.from_execution_events().where_iteration(profiled_iteration).where_stage(ApplicationStage::forward).get();
+        std::unordered_map<OperatorId, long> request_timepoints;
+        for (auto &x : iter_1_forward_res.ref()) {
+            long timestamp = utils::get_timestamp_val(x->second.timestamp);
+            if (x->second.type == events::ExecutionEventType::request) request_timepoints[x->second.op] = timestamp;
+            else if (x->second.type == events::ExecutionEventType::release && request_timepoints.count(x->second.op) == 1) forward_timespans[status.getOperatorName(x->second.op)] = timestamp - request_timepoints.at(x->second.op);
+        }
+    }
 
-            auto& schedule_events_set = schedule_events.backward_schedule_events.execution;
-            auto q = std::find_if(schedule_events_set[p->second.current_operator].begin(), schedule_events_set[p->second.current_operator].end(), [event](const events::ScheduleEvent& _event) {
-                return _event.tensor_name == event.tensor;
-            });
-            assert(q != schedule_events_set[p->second.current_operator].end());
+    virtual std::unordered_set<TensorId> analyzeForwardEvents(const events::EventSet<events::MemoryEvent>& iter_1_forward_mem_res) override {
+        std::unordered_set<TensorId> tensors_swapped = DependencyAwareMemoryScheduler::analyzeForwardEvents(iter_1_forward_mem_res);
+
+        std::unordered_set<std::string> tensors_recomputed;
+        for (auto p = tensors_swapped.begin(); p != tensors_swapped.end(); ) {
+            status::ConstTensorPres pres = status.referenceConstTensor(*p);
+            auto q = forward_timespans.find(pres.getOperatorName());
+            // Producer not profiled.
+            if (q == forward_timespans.end()) { ++p; continue; }
+            // Swapping out and swapping in.
+            long transferring_time = transferring_model.analyze(pres.getSize()) * 2;
+            if (q->second >= transferring_time) { ++p; continue; }
+
+            tensors_recomputed.insert(pres.getName());
+            p = tensors_swapped.erase(p);
+        }
 
-            std::string opb = "";
-            if (event.type == events::MemoryEventType::swapin) {
-                if (p->second.position == -4)   return;
-                if (!status.hasExecutionPrev(p->second.current_operator)) return;
-                opb = status.getExecutionPrev(p->second.current_operator);
-                p->second.position -= 1;
+        for (auto &x : schedule_events.forward_schedule_events.execution) {
+            for (auto &y : x.second) {
+                if (y.type == events::ScheduleEventType::swapout && tensors_recomputed.count(y.tensor_name) == 1) y.type = events::ScheduleEventType::recompute;
             }
-            else {
-                if (p->second.position == 4)    return;
-                if (!status.hasExecutionPost(p->second.current_operator)) return;
-                opb = status.getExecutionPost(p->second.current_operator);
-                p->second.position += 1;
-                tensor_swapout_this_iter.insert(event.tensor);
+        }
+        // Recomputed tensors are not prefetched in backward propagation.
+        return tensors_swapped;
+    }
+
+    virtual void onReplan() override {
+        DependencyAwareMemoryScheduler::onReplan();
+        forward_timespans.clear();
+    }
+
+public:
+    RecomputationAwareMemoryScheduler(const Context::View& _context, status::MemoryStatus& _status, events::Events& _events): DependencyAwareMemoryScheduler(_context, _status, _events) {}
+    virtual ~RecomputationAwareMemoryScheduler() = default;
+};  // struct RecomputationAwareMemoryScheduler
+
+/**
+ * CostOptimalMemoryScheduler
+ * Plan the swapping over the profiled iteration with decisions::SwapModel, minimizing the predicted stall subject to the device capacity at every operator.
+ */
+struct CostOptimalMemoryScheduler : public EventBasedMemoryScheduler {
+protected:
+    struct TensorTrace final {
+        size_t size       = 0;
+        bool   swappable  = false;
+        int    allocated  = -1;     // -1 if allocated before the iteration.
+        int    freed      = -1;     // -1 if not freed in the iteration.
+        int    last_forward   = -1;
+        int    first_backward = -1;
+        OperatorId last_forward_op = invalid_id;
+    };  // inner struct TensorTrace
+
+    decisions::TransferringModel transferring_model;
+    decisions::SwapModel         swap_model;
+
+    // Positions of the operators in the sequence of forward and backward propagation.
+    std::unordered_map<OperatorId, int> forward_positions;
+    std::unordered_map<OperatorId, int> backward_positions;
+    int forward_count = 0;
+    std::vector<std::string> sequence;
+    std::vector<long> timespans;
+
+    std::unordered_map<TensorId, TensorTrace> traces;
+
+protected:
+    int getPosition(OperatorId op, ApplicationStage stage) const {
+        const auto& positions = stage == ApplicationStage::forward ? forward_positions : backward_positions;
+        auto p = positions.find(op);
+        return p == positions.end() ? -1 : p->second;
+    }
+
+    void traceEvents(const events::EventSet<events::MemoryEvent>& res) {
+        for (auto &x : res.ref()) {
+            const events::MemoryEvent& event = x->second;
+            if (!isAccessEvent(event)) continue;
+            int posi = getPosition(event.op, event.stage);
+            if (posi == -1 || event.tensor == invalid_id) continue;
+
+            auto p = traces.find(event.tensor);
+            if (p == traces.end()) {
+                if (!status.isTensorRegistered(event.tensor)) continue;
+                status::ConstTensorPres pres = status.referenceConstTensor(event.tensor);
+                // Persistent and transient tensors are not located in the common block.
+                if (pres.isPersistent() || pres.isTransient()) continue;
+                p = traces.emplace(event.tensor, TensorTrace()).first;
+                p->second.size = pres.getSize();
             }
-            // Cannot solve this schedule problem.
-            assert(opb != "");
-            
-            events::ScheduleEvent new_event = *q;
-            new_event.operator_name = opb;
-            schedule_events_set[opb].push_back(new_event);
-            schedule_events_set[p->second.current_operator].erase(q);
 
-            p->second.current_operator = opb;
-            p->second.schedule_changed = true;
+            TensorTrace& trace = p->second;
+            switch (event.type) {
+                case events::MemoryEventType::allocate:
+                    trace.allocated = posi;
+                    trace.swappable = event.stage == ApplicationStage::forward;
+                    break;
+                case events::MemoryEventType::free:
+                    trace.freed = posi;
+                    if (event.stage == ApplicationStage::forward) trace.swappable = false;
+                    continue;
+                default:
+                    break;
+            }
+            if (event.stage == ApplicationStage::forward) {
+                trace.last_forward    = posi;
+                trace.last_forward_op = event.op;
+            } else if (trace.first_backward == -1) trace.first_backward = posi;
         }
     }
-    virtual void onNewIteration() override {
-        tensor_swapout_this_iter.clear();
+
+    virtual void preAnalyzeEvents() override {
+        std::vector<std::string> forward_order  = status.getForwardExecutionOrder().toVector();
+        std::vector<std::string> backward_order = status.getBackwardExecutionOrder().toVector();
+        forward_count = forward_order.size();
+        sequence.clear();
+        for (auto &s : forward_order) {
+            forward_positions[status.getOperatorId(s)] = sequence.size();
+            sequence.push_back(s);
+        }
+        for (auto &s : backward_order) {
+            backward_positions[status.getOperatorId(s)] = sequence.size();
+            sequence.push_back(s);
+        }
+
+        timespans.assign(sequence.size(), 0);
+        auto iter_1_exec_res = events.from_execution_events().where_iteration(profiled_iteration).get();
+        std::vector<long> requests(sequence.size(), -1);
+        for (auto &x : iter_1_exec_res.ref()) {
+            int posi = getPosition(x->second.op, x->second.stage);
+            if (posi == -1) continue;
+            long timestamp = utils::get_timestamp_val(x->second.timestamp);
+            if (x->second.type == events::ExecutionEventType::request) requests[posi] = timestamp;
+            else if (x->second.type == events::ExecutionEventType::release && requests[posi] != -1) timespans[posi] = timestamp - requests[posi];
+        }
     }
 
-    virtual ~DependencyAwareMemoryScheduler() = default;
+    virtual std::unordered_set<TensorId> analyzeForwardEvents(const events::EventSet<events::MemoryEvent>& iter_1_forward_mem_res) override {
+        traceEvents(iter_1_forward_mem_res);
 
-};  // struct DependencyAwareMemoryScheduler
+        std::unordered_set<TensorId> re;
+        for (auto &x : traces) {
+            if (x.second.swappable) re.insert(x.first);
+        }
+        return re;
+    }
+
+    virtual void analyzeBackwardEvents(const events::EventSet<events::MemoryEvent>& iter_1_backward_mem_res, const std::unordered_set<TensorId>& tensors_swappable) override {
+        traceEvents(iter_1_backward_mem_res);
+
+        int count = sequence.size();
+        std::vector<size_t> demands(count, 0);
+        for (auto &x : traces) {
+            int begin = x.second.allocated == -1 ? 0 : x.second.allocated;
+            int end   = x.second.freed == -1 ? count - 1 : x.second.freed;
+            for (int i = begin; i <= end; ++i) demands[i] += x.second.size;
+        }
+
+        const MemoryInfo::Device& device = status.getMemoryInfo().device;
+        swap_model.setCapacity(device.common_block.size == 0 ? device.total_size : device.common_block.size);
+        swap_model.setSequence(demands, timespans);
+
+        std::vector<TensorId> candidates;
+        for (auto x : tensors_swappable) {
+            const TensorTrace& trace = traces.at(x);
+            if (trace.first_backward == -1 || trace.last_forward_op == invalid_id) continue;
+            candidates.push_back(x);
+            swap_model.submitCandidate(decisions::SwapModel::Candidate(status.getTensorName(x), trace.size, transferring_model.analyze(trace.size), trace.last_forward, trace.first_backward, forward_count + 1));
+        }
+        swap_model.analyze();
+
+        const std::vector<decisions::SwapModel::Decision>& decisions = swap_model.getDecisions();
+        for (size_t n = 0; n < candidates.size(); ++n) {
+            const decisions::SwapModel::Decision& decision = decisions[n];
+            if (!decision.swapped) continue;
+
+            status::ConstTensorPres pres = status.referenceConstTensor(candidates[n]);
+            const std::string& last_acquired_name = status.getOperatorName(traces.at(candidates[n]).last_forward_op);
+            schedule_events.forward_schedule_events.execution[last_acquired_name].emplace_back(pres.getOperatorName(), pres.getName(), pres.getSize(), events::ScheduleEventType::swapout, last_acquired_name);
+            // Swapped in on demand if the prefetching is issued at the access.
+            if (decision.prefetch == traces.at(candidates[n]).first_backward) continue;
+            const std::string& opb = sequence[decision.prefetch - 1];
+            schedule_events.backward_schedule_events.execution[opb].emplace_back(pres.getOperatorName(), pres.getName(), pres.getSize(), events::ScheduleEventType::copyin, opb);
+        }
+
+        schedule_events.predicted_peak_memory = swap_model.getPredictedPeakMemory();
+        schedule_events.predicted_stall       = swap_model.getPredictedStall();
+    }
+
+    virtual void postAnalyzeEvents() override {}
+
+    virtual void onReplan() override {
+        EventBasedMemoryScheduler::onReplan();
+        forward_positions.clear();
+        backward_positions.clear();
+        traces.clear();
+        swap_model.clearCandidates();
+    }
+
+public:
+    CostOptimalMemoryScheduler(const Context::View& _context, status::MemoryStatus& _status, events::Events& _events): EventBasedMemoryScheduler(_context, _status, _events) {
+        swap_model.setResolution(std::stoul(context.at("optimal.resolution")));
+    }
+    virtual ~CostOptimalMemoryScheduler() = default;
+};  // struct CostOptimalMemoryScheduler
 
 }   // namespace mori
\ No newline at end of file
@@ -1,9 +1,169 @@
 #pragma once
 
+#include <vector>
+#include <algorithm>
+#include <limits>
+
 namespace mori {
 namespace utils {
 
+/**
+ * select_covering
+ * Select the items covering the residual with the minimal total cost.
+ * Solved as a minimum-cost covering knapsack by dynamic programming. The sizes are quantized to at most resolution units, rounding down to keep the covering conservative.
+ * @return indices of the selected items, empty if the items cannot cover the residual
+ */
+inline static std::vector<size_t> select_covering(const std::vector<size_t>& sizes, const std::vector<long>& costs, size_t residual, size_t resolution) {
+    size_t unit = std::max<size_t>(1, (residual - 1) / resolution + 1);
+    size_t target = (residual - 1) / unit + 1;
+
+    constexpr long infinity = std::numeric_limits<long>::max();
+    std::vector<long> totals(target + 1, infinity);
+    std::vector<std::vector<bool>> chosen(sizes.size(), std::vector<bool>(target + 1, false));
+    totals[0] = 0;
+    for (size_t n = 0; n < sizes.size(); ++n) {
+        size_t units = sizes[n] / unit;
+        if (units == 0) continue;
+        for (size_t u = target; u > 0; --u) {
+            size_t prev = u > units ? u - units : 0;
+            if (totals[prev] == infinity) continue;
+            if (totals[prev] + costs[n] >= totals[u]) continue;
+            totals[u] = totals[prev] + costs[n];
+            chosen[n][u] = true;
+        }
+    }
+
+    std::vector<size_t> re;
+    if (totals[target] == infinity) return re;
+    size_t u = target;
+    for (size_t n = sizes.size(); n > 0 && u > 0; --n) {
+        if (!chosen[n - 1][u]) continue;
+        re.push_back(n - 1);
+        size_t units = sizes[n - 1] / unit;
+        u = u > units ? u - units : 0;
+    }
+    return re;
+}
+
+/**
+ * VictimSelector
+ * Select the tensors to swap out in forward propagation, bounded by the memory demand.
+ * Positions index the operators in the forward execution order. The deficit at a position is the memory to be released before the operator executes.
+ * Swapping out a victim releases its memory from the position after its last access, through the rest of forward propagation.
+ */
+struct VictimSelector final {
+public:
+    struct Victim final {
+        size_t size     = 0;
+        long   transfer = 0;    // Transferring time in microseconds.
+        long   idle     = 0;    // Time unused between the last access in forward and the first access in backward, in microseconds.
+        size_t released = 0;    // The first position where the memory is released.
+
+        Victim() = default;
+        Victim(size_t _size, long _transfer, long _idle, size_t _released): size(_size), transfer(_transfer), idle(_idle), released(_released) {}
+    };  // inner struct Victim
+
+private:
+    size_t resolution = 4096;
+
+    std::vector<size_t> deficits;
+    std::vector<Victim> victims;
+    std::vector<bool>   selected;
+    // Memory released by the selected victims at each position.
+    std::vector<size_t> releases;
+
+protected:
+    /**
+     * The transferring, plus the round trip not overlapped by the idle time, which stalls the training.
+     */
+    static long getWeight(const Victim& victim) {
+        long exposed = 2 * victim.transfer - victim.idle;
+        return victim.transfer + std::max(0L, exposed);
+    }
+
+    void applyRelease(size_t index, bool release) {
+        for (size_t i = victims[index].released; i < releases.size(); ++i) {
+            if (release) releases[i] += victims[index].size;
+            else releases[i] -= victims[index].size;
+        }
+    }
+
+    bool isRemovable(size_t index) const {
+        const Victim& victim = victims[index];
+        for (size_t i = victim.released; i < deficits.size(); ++i) {
+            if (releases[i] < victim.size || releases[i] - victim.size < deficits[i]) return false;
+        }
+        return true;
+    }
+
+    /**
+     * Select the victims to cover the residual, with the minimal weight.
+     */
+    std::vector<size_t> selectCovering(const std::vector<size_t>& available, size_t residual) const {
+        std::vector<size_t> sizes;
+        std::vector<long>   weights;
+        for (auto n : available) {
+            sizes.push_back(victims[n].size);
+            weights.push_back(getWeight(victims[n]));
+        }
+        std::vector<size_t> re = select_covering(sizes, weights, residual, resolution);
+        for (auto &x : re) x = available[x];
+        return re;
+    }
+
+public:
+    VictimSelector() = default;
+
+    inline void setResolution(size_t _resolution) { resolution = std::max<size_t>(1, _resolution); }
+
+    /**
+     * Set the deficit at each position. The deficit counts all the memory to be released till the position, since the released memory stays released through forward propagation.
+     */
+    void setDeficits(const std::vector<size_t>& _deficits) { deficits = _deficits; }
+
+    size_t submitVictim(const Victim& victim) {
+        victims.push_back(victim);
+        return victims.size() - 1;
+    }
+
+    /**
+     * select
+     * Cover the deficits in the order of positions. The victims made redundant by the later selection are restored, the heaviest first.
+     * If a deficit cannot be covered, all the victims available at the position are selected.
+     */
+    void select() {
+        selected.assign(victims.size(), false);
+        releases.assign(deficits.size(), 0);
+
+        for (size_t i = 0; i < deficits.size(); ++i) {
+            size_t released = releases[i];
+            if (released >= deficits[i]) continue;
+
+            std::vector<size_t> available;
+            for (size_t n = 0; n < victims.size(); ++n) {
+                if (!selected[n] && victims[n].released <= i) available.push_back(n);
+            }
+            std::vector<size_t> re = selectCovering(available, deficits[i] - released);
+            // Not enough memory could be released. Release as much as possible.
+            if (re.empty()) re = available;
+            for (auto n : re) {
+                selected[n] = true;
+                applyRelease(n, true);
+            }
+        }
+
+        std::vector<size_t> order;
+        for (size_t n = 0; n < victims.size(); ++n) if (selected[n]) order.push_back(n);
+        std::sort(order.begin(), order.end(), [this](size_t x, size_t y) { return getWeight(victims[x]) > getWeight(victims[y]); });
+        for (auto n : order) {
+            if (!isRemovable(n)) continue;
+            applyRelease(n, false);
+            selected[n] = false;
+        }
+    }
 
+    inline bool isSelected(size_t index) const { return selected[index]; }
+};  // struct VictimSelector
 
 }   // namespace utils
-}   // namespace mori
\ No newline at end of file
+}   // namespace mori
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <chrono>
+#include <vector>
+#include <algorithm>
+#include <iostream>
+#include <string>
+
+namespace bench {
+
+/**
+ * Run the function for the rounds, and report the average time per round in microseconds.
+ */
+template <typename Func>
+double measure(const std::string& name, size_t rounds, Func&& func) {
+    auto begin = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < rounds; ++i) func();
+    double elapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - begin).count() / rounds;
+    std::cout << name << ": " << elapsed << " us" << std::endl;
+    return elapsed;
+}
+
+/**
+ * Report the percentile of the sampled times in microseconds.
+ */
+inline double percentile(const std::string& name, std::vector<double> samples, double percentile) {
+    auto p = samples.begin() + std::min(samples.size() - 1, size_t(samples.size() * percentile / 100));
+    std::nth_element(samples.begin(), p, samples.end());
+    std::cout << name << " (p" << percentile << "): " << *p << " us" << std::endl;
+    return *p;
+}
+
+// Keep the results observable so that the measured work is not optimized out.
+static volatile size_t sink = 0;
+
+}   // namespace bench
@@ -0,0 +1,47 @@
+#include <mutex>
+#include <string>
+#include <vector>
+#include <chrono>
+
+#include "frontend/frontend.hpp"
+#include "demo_memory_manager.hpp"
+#include "bench/bench_utils.hpp"
+
+using namespace mori;
+
+/**
+ * Latency of releasing an operator request on the training thread, which submits the release event,
+ * with the events ingested by the background worker and on the training thread.
+ */
+static void measureRelease(const std::string& name, bool async_ingestion) {
+    constexpr size_t rounds = 100000;
+
+    Context context;
+    context["events.async"] = async_ingestion ? "true" : "false";
+    DemoMemoryManager mem_manager;
+    Logger logger;
+    Frontend frontend(context);
+    frontend.setMemoryManager(&mem_manager);
+    frontend.setLogger(&logger);
+    frontend.init();
+    frontend.registerOperator(status::Operator("op"));
+    frontend.start();
+
+    MemorySession& session = frontend.getSession();
+    std::vector<double> samples(rounds);
+    for (auto &x : samples) {
+        MemorySession::Request request = session.createRequest("op");
+        request.setOperationStarted();
+        auto begin = std::chrono::steady_clock::now();
+        request.release();
+        x = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - begin).count();
+    }
+    bench::percentile(name, samples, 99);
+    frontend.stop();
+}
+
+int main() {
+    measureRelease("request release, async ingestion", true);
+    measureRelease("request release, sync ingestion", false);
+    return 0;
+}
@@ -0,0 +1,79 @@
+#include <mutex>
+
+#include "backend/events.hpp"
+#include "backend/schedulers/memory_scheduler.hpp"
+#include "bench/bench_utils.hpp"
+
+using namespace mori;
+
+/**
+ * Cost of the per-tensor queries of the schedule planning, over the events of a model with 10k operators.
+ * The indexed conditions are compared with the equivalent opaque predicates.
+ * The schedule planning of the dependency-aware scheduler is timed over the same trace, with a quarter of the tensors passively swapped out at the middle of forward propagation.
+ */
+int main() {
+    constexpr size_t operator_count = 10000;
+    constexpr size_t tensor_count   = 4;
+    constexpr size_t iterations     = 3;
+
+    status::MemoryStatus status;
+    for (OperatorId op = 0; op < operator_count; ++op) {
+        std::string op_name = "op" + std::to_string(op);
+        status::Operator op_status(op_name);
+        for (size_t j = 0; j < tensor_count; ++j) {
+            std::string tensor_name = op_name + "_t" + std::to_string(j);
+            status.registerTensor(status::Tensor(tensor_name, 1024));
+            op_status.setTensor(tensor_name);
+        }
+        if (op != 0) op_status.setPrev("op" + std::to_string(op - 1));
+        status.registerOperator(op_status);
+    }
+
+    events::Events events;
+    for (size_t i = 0; i < iterations; ++i) {
+        events.newIteration();
+        for (OperatorId op = 0; op < operator_count; ++op) {
+            for (size_t j = 0; j < tensor_count; ++j) {
+                TensorId tensor = op * tensor_count + j;
+                events.submitEvent(events::MemoryEvent(op, tensor, 1024, events::MemoryEventType::allocate, ApplicationStage::forward));
+                events.submitEvent(events::MemoryEvent(op, tensor, 1024, events::MemoryEventType::write, ApplicationStage::forward));
+                events.submitEvent(events::MemoryEvent(op, tensor, 1024, events::MemoryEventType::read, ApplicationStage::backward));
+            }
+            // Memory insufficient at the middle of forward propagation.
+            if (op != operator_count / 2) continue;
+            for (TensorId tensor = 0; tensor < operator_count; tensor += tensor_count) {
+                events.submitEvent(events::MemoryEvent(op, tensor, 1024, events::MemoryEventType::swapout, ApplicationStage::forward));
+            }
+        }
+    }
+
+    auto iter_res = events.from_memory_events().where_iteration(1).where_stage(ApplicationStage::forward).get();
+    // The first query builds the indices.
+    bench::sink += iter_res.select().where_tensor(0).get().size();
+
+    constexpr size_t queries = 1000;
+    bench::measure("indexed tensor query of iteration", queries, [&]() {
+        static TensorId tensor = 0;
+        bench::sink += events.from_memory_events().where_iteration(1).where_tensor(tensor++ % (operator_count * tensor_count)).get().size();
+    });
+    bench::measure("indexed tensor query of selection", queries, [&]() {
+        static TensorId tensor = 0;
+        bench::sink += iter_res.select().where_tensor(tensor++ % (operator_count * tensor_count)).get().size();
+    });
+    bench::measure("predicate tensor query of selection", queries, [&]() {
+        static TensorId tensor = 0;
+        TensorId target = tensor++ % (operator_count * tensor_count);
+        bench::sink += iter_res.select().where([target](const events::EventSet<events::MemoryEvent>::item& item) { return item.second.tensor == target; }).get().size();
+    });
+    bench::measure("indexed operator query of selection", queries, [&]() {
+        static OperatorId op = 0;
+        bench::sink += iter_res.select().where_operator(op++ % operator_count).get().size();
+    });
+
+    Context context;
+    bench::measure("schedule planning", 3, [&]() {
+        DependencyAwareMemoryScheduler scheduler(context.view("scheduler"), status, events);
+        bench::sink += scheduler.getScheduleEvents().forward_schedule_events.execution.size();
+    });
+    return 0;
+}
@@ -0,0 +1,53 @@
+#include <mutex>
+#include <cassert>
+#include <new>
+#include <atomic>
+#include <cstdlib>
+#include <vector>
+
+#include "includes/memory_layout.hpp"
+#include "bench/bench_utils.hpp"
+
+using namespace mori;
+
+static std::atomic<size_t> allocations{0};
+
+void* operator new(size_t size) {
+    ++allocations;
+    void* re = std::malloc(size == 0 ? 1 : size);
+    if (re == nullptr) throw std::bad_alloc();
+    return re;
+}
+void operator delete(void* address) noexcept { std::free(address); }
+void operator delete(void* address, size_t) noexcept { std::free(address); }
+
+/**
+ * Cost and heap allocations of recording the allocating and freeing of tensors in a memory block, in steady state.
+ */
+int main() {
+    constexpr size_t block_size  = 1 << 30;
+    constexpr size_t tensor_size = 1 << 20;
+    constexpr size_t slots       = 512;
+
+    MemoryInfo info = create_default_memory_info(block_size, block_size);
+    info.device.common_block.address = (void*)0x100000000;
+    info.device.common_block.size    = block_size;
+    layout::MemoryLayout layout;
+    layout.setMemoryInfo(info);
+
+    auto address = [&](size_t slot) { return (void*)((uint8_t*)info.device.common_block.address + slot * tensor_size); };
+    for (size_t i = 0; i < slots; ++i) layout.recordMemoryAllocateEvent(address(i), tensor_size, i);
+
+    // Free and allocate again every other slot, which splits and merges the regions.
+    auto churn = [&]() {
+        for (size_t i = 0; i < slots; i += 2) layout.recordMemoryFreeEvent(address(i));
+        for (size_t i = 0; i < slots; i += 2) layout.recordMemoryAllocateEvent(address(i), tensor_size, i);
+    };
+    churn();
+
+    size_t allocations_b = allocations;
+    constexpr size_t rounds = 1000;
+    bench::measure("layout churn of 256 tensors", rounds, churn);
+    std::cout << "heap allocations per churn: " << (double)(allocations - allocations_b) / rounds << std::endl;
+    return 0;
+}
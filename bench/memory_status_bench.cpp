@@ -0,0 +1,101 @@
+#include <mutex>
+#include <new>
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "includes/memory_status.hpp"
+#include "frontend/frontend.hpp"
+#include "demo_memory_manager.hpp"
+#include "bench/bench_utils.hpp"
+
+using namespace mori;
+
+static std::atomic<size_t> allocations{0};
+
+void* operator new(size_t size) {
+    ++allocations;
+    void* re = std::malloc(size == 0 ? 1 : size);
+    if (re == nullptr) throw std::bad_alloc();
+    return re;
+}
+void operator delete(void* address) noexcept { std::free(address); }
+void operator delete(void* address, size_t) noexcept { std::free(address); }
+
+/**
+ * Cost of reading the execution order, the operator tensors and the name tables of a model with many operators,
+ * the heap allocations of a waitMemory pass over the operators, and the handle lookups while tensors are registered concurrently.
+ */
+int main() {
+    constexpr size_t operator_count = 10000;
+    constexpr size_t tensor_count   = 4;
+
+    MemoryStatus status;
+    for (size_t i = 0; i < operator_count; ++i) {
+        std::string op_name = "op" + std::to_string(i);
+        status::Operator op(op_name);
+        for (size_t j = 0; j < tensor_count; ++j) {
+            std::string tensor_name = op_name + "_t" + std::to_string(j);
+            status.registerTensor(tensor_name);
+            op.setTensor(tensor_name);
+        }
+        if (i != 0) op.setPrev("op" + std::to_string(i - 1));
+        status.registerOperator(op);
+    }
+
+    bench::measure("execution order traversal", 100, [&]() {
+        for (auto &s : status.getExecutionOrder()) bench::sink += s.size();
+    });
+    bench::measure("operator tensors traversal", 10, [&]() {
+        for (auto &s : status.getExecutionOrder()) {
+            status::ConstOperatorPres pres = status.referenceConstOperator(s);
+            for (auto &t : pres.getTensors()) bench::sink += t.size();
+        }
+    });
+    bench::measure("tensor name table", 100, [&]() {
+        bench::sink += status.getTensors().size();
+    });
+
+    // A started frontend with the same operators. No tensor is located on device, hence waitMemory visits the tensors of all the operators.
+    Context context;
+    DemoMemoryManager mem_manager;
+    Logger logger;
+    Frontend frontend(context);
+    frontend.setMemoryManager(&mem_manager);
+    frontend.setLogger(&logger);
+    frontend.init();
+    for (size_t i = 0; i < operator_count; ++i) {
+        std::string op_name = "op" + std::to_string(i);
+        for (size_t j = 0; j < tensor_count; ++j) frontend.registerTensor(status::Tensor(op_name + "_t" + std::to_string(j), 256));
+        frontend.registerOperator(status.referenceConstOperator(op_name).get());
+    }
+    frontend.start();
+
+    constexpr size_t wait_rounds = 100;
+    MemorySession& session = frontend.getSession();
+    session.waitMemory(1024);
+    size_t allocations_b = allocations.load();
+    bench::measure("waitMemory over all operators", wait_rounds, [&]() { bench::sink += session.waitMemory(1024); });
+    std::cout << "heap allocations per waitMemory: " << double(allocations.load() - allocations_b) / wait_rounds << std::endl;
+    frontend.stop();
+
+    auto lookup = [&]() {
+        for (TensorId i = 0; i < 1000; ++i) {
+            bench::sink += status.isTensorRegistered(i);
+            bench::sink += status.referenceConstTensor(i).getSize();
+        }
+    };
+    status.setConcurrent(true);
+    bench::measure("handle lookup (x1000)", 1000, lookup);
+
+    std::atomic<bool> stopped{false};
+    std::thread registration([&]() {
+        for (size_t i = 0; !stopped.load(); ++i) status.registerTensor("concurrent_t" + std::to_string(i));
+    });
+    bench::measure("handle lookup under concurrent registration (x1000)", 1000, lookup);
+    stopped = true;
+    registration.join();
+    return 0;
+}
@@ -123,10 +123,8 @@ public:
             }
 
             for (auto &s : op.prevs) {
-                for (auto &s1 : operators.at(s).tensors) {
-                    request.waitTensor(s1);
-                    request.setMemoryDataAcquired(s1);
-                }
+                request.waitOperator(s);
+                for (auto &s1 : operators.at(s).tensors) request.setMemoryDataAcquired(s1);
             }
 
             request.setOperationStarted();
@@ -143,10 +141,8 @@ public:
             Operator& op = operators.at(*p);
             auto request = session.createRequest(*p);
             for (auto &s : op.prevs) {
-                for (auto &s1 : operators.at(s).tensors) {
-                    request.waitTensor(s1);
-                    request.setMemoryDataAcquired(s1);
-                }
+                request.waitOperator(s);
+                for (auto &s1 : operators.at(s).tensors) request.setMemoryDataAcquired(s1);
             }
 
             request.setOperationStarted();
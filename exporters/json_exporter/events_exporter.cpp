@@ -13,24 +13,39 @@ namespace events {
 
 static void to_json(nlohmann::json& obj, const MemoryEvent& event) {
     obj["type"] = "memory";
-    obj["event"]["operator"] = event.op;
-    obj["event"]["tensor"] = event.tensor;
+    obj["event"]["operator_id"] = event.op;
+    obj["event"]["tensor_id"] = event.tensor;
     obj["event"]["size"]   = event.size;
     obj["event"]["type"] = events::utils::get_event_type_str(event.type);
     obj["event"]["stage"] = mori::utils::get_application_stage_str(event.stage);
-    obj["event"]["timestamp"] = mori::utils::get_timestamp_val(event.timestamp);
+    obj["event"]["timestamp"] = mori::utils::get_millisecond_val(mori::utils::get_timestamp_val(event.timestamp));
+    obj["event"]["stall"] = mori::utils::get_millisecond_val(event.stall);
 }
 
 static void to_json(nlohmann::json& obj, const ExecutionEvent& event) {
     obj["type"] = "execution";
-    obj["event"]["operator"] = event.op;
+    obj["event"]["operator_id"] = event.op;
     obj["event"]["type"] = events::utils::get_event_type_str(event.type);
     obj["event"]["stage"] = mori::utils::get_application_stage_str(event.stage);
-    obj["event"]["timestamp"] = mori::utils::get_timestamp_val(event.timestamp);
+    obj["event"]["timestamp"] = mori::utils::get_millisecond_val(mori::utils::get_timestamp_val(event.timestamp));
 }
 
 }   // namespace events
 
+namespace layout {
+
+static void to_json(nlohmann::json& obj, const BlockStatistics& statistics) {
+    obj["block"] = mori::utils::get_memory_block_type_str(statistics.type);
+    obj["device"] = statistics.device;
+    obj["total_size"] = statistics.total_size;
+    obj["free_size"] = statistics.free_size;
+    obj["largest_free_size"] = statistics.largest_free_size;
+    obj["free_region_count"] = statistics.free_region_count;
+    obj["fragmentation"] = statistics.getFragmentation();
+}
+
+}   // namespace layout
+
 namespace exporter {
 
 using json = nlohmann::json;
@@ -40,10 +55,20 @@ struct JSONEventsExporter : public EventsExporter {
 
     virtual void onMemoryEvent(const events::MemoryEvent& event) const override {
         json obj = event;
+        obj["event"]["operator"] = status->getOperatorName(event.op);
+        obj["event"]["tensor"]   = status->getTensorName(event.tensor);
         export_method->exportMessage(obj.dump(2));
     }
     virtual void onExecutionEvent(const events::ExecutionEvent& event) const override {
         json obj = event;
+        obj["event"]["operator"] = status->getOperatorName(event.op);
+        export_method->exportMessage(obj.dump(2));
+    }
+    virtual void onLayoutStatistics(int iteration, const std::vector<layout::BlockStatistics>& statistics) const override {
+        json obj;
+        obj["type"] = "layout";
+        obj["iteration"] = iteration;
+        obj["blocks"] = statistics;
         export_method->exportMessage(obj.dump(2));
     }
 
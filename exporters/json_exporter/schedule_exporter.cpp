@@ -34,7 +34,7 @@ static void to_json(nlohmann::json& obj, const ScheduleEvent& event) {
     obj["size"]          = event.size;
     obj["type"]          = event.type;
     obj["post_operator"] = event.postop;
-    obj["timepoint"]     = event.timepoint;
+    obj["timepoint"]     = mori::utils::get_millisecond_val(event.timepoint);
 }
 
 }   // namespace events
@@ -61,6 +61,12 @@ struct JSONScheduleExporter : public ScheduleExporter {
         obj["backward_schedule_events"]["execution"] = events.backward_schedule_events.execution;
         obj["backward_schedule_events"]["timepoint"] = events.backward_schedule_events.timepoint;
 
+        obj["predicted_peak_memory"] = events.predicted_peak_memory;
+        obj["predicted_stall"]       = mori::utils::get_millisecond_val(events.predicted_stall);
+
+        obj["slacks"] = json::object();
+        for (auto &x : events.slacks) obj["slacks"][x.first] = mori::utils::get_millisecond_val(x.second);
+
         export_method->exportMessage(obj.dump(2));
     }
 
@@ -12,16 +12,18 @@ extern "C" __attribute__((visibility("default"))) int tensors_exporter_entry(std
 namespace mori {
 namespace status {
 
-static void to_json(nlohmann::json& obj, const TensorPres& pres) {
+static void to_json(nlohmann::json& obj, const ConstTensorPres& pres) {
     obj["name"] = pres.getName();
+    obj["id"]   = pres.getId();
     obj["size"] = pres.getSize();
     obj["type"] = status::utils::get_tensor_type_str(pres.getType());
     obj["persistent"] = pres.isPersistent();
     obj["transient"]  = pres.isTransient();
 }
 
-static void to_json(nlohmann::json& obj, const OperatorPres& pres) {
+static void to_json(nlohmann::json& obj, const ConstOperatorPres& pres) {
     obj["name"] = pres.getName();
+    obj["id"]   = pres.getId();
     obj["backprop"] = pres.isBackwardPropagation();
     obj["tensors"] = pres.getTensors();
     obj["prevs"] = pres.getPrevs();
@@ -43,16 +45,16 @@ struct JSONTensorsExporter : public TensorsExporter {
         obj["operators"] = json();
 
         for (auto &s : status.getTensors()) {
-            status::TensorPres pres = status.referenceTensor(s);
+            status::ConstTensorPres pres = status.referenceConstTensor(s);
             obj["tensors"][s] = pres;
         }
         for (auto &s : status.getOperators()) {
-            status::OperatorPres pres = status.referenceOperator(s);
+            status::ConstOperatorPres pres = status.referenceConstOperator(s);
             obj["operators"][s] = pres;
         }
 
         obj["entry"] = status.getEntry();
-        obj["execution_order"] = status.getExecutionOrder();
+        obj["execution_order"] = status.getExecutionOrder().toVector();
 
         export_method->exportMessage(obj.dump(2));
     }
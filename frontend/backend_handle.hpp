@@ -32,11 +32,13 @@ struct BackendHandle {
     virtual void init() = 0;
 
     virtual void submitMemoryStatus(const status::MemoryStatus& status) = 0;
+    virtual void submitMemoryStatusDelta(const status::MemoryStatusDelta& delta) = 0;
 
     virtual void start() {}
     
     virtual void submitEvent(const events::MemoryEvent& event) = 0;
     virtual void submitEvent(const events::ExecutionEvent& event) = 0;
+    virtual void submitLayoutStatistics(const std::vector<layout::BlockStatistics>&) {}
     virtual events::ScheduleEvents getScheduleEvents() = 0;
 
     virtual void setIteration(int _iteration) = 0;
@@ -58,10 +60,15 @@ struct BackendHandle {
 
 struct LocalBackendHandle : public BackendHandle {
     std::unique_ptr<Backend> backend;
+    bool log_events = false;
 
     LocalBackendHandle() {}
+    LocalBackendHandle(const Context& _context) {
+        log_events = _context.signal("events.log");
+    }
     LocalBackendHandle(LocalBackendHandle&& backend_handle) {
         backend = std::move(backend_handle.backend);
+        log_events = backend_handle.log_events;
     }
 
     virtual void init() override {
@@ -73,17 +80,23 @@ struct LocalBackendHandle : public BackendHandle {
     virtual void submitMemoryStatus(const status::MemoryStatus& _status) override {
         backend->submitMemoryStatus(_status);
     }
+    virtual void submitMemoryStatusDelta(const status::MemoryStatusDelta& delta) override {
+        backend->submitMemoryStatusDelta(delta);
+    }
 
     virtual void start() override { backend->start(); }
 
     virtual void submitEvent(const events::MemoryEvent& event) override {
-        (*logger) << LogLevel::debug << "Submiting of event " << event << endl;
+        if (log_events) (*logger) << LogLevel::debug << "Submiting of event " << event << endl;
         backend->submitEvent(event);
     }
     virtual void submitEvent(const events::ExecutionEvent& event) override {
-        (*logger) << LogLevel::debug << "Submiting of event " << event << endl;
+        if (log_events) (*logger) << LogLevel::debug << "Submiting of event " << event << endl;
         backend->submitEvent(event);
     }
+    virtual void submitLayoutStatistics(const std::vector<layout::BlockStatistics>& statistics) override {
+        backend->submitLayoutStatistics(statistics);
+    }
 
     virtual void setIteration(int _iteration) override { backend->setIteration(_iteration); }
     virtual void newIteration() override { backend->newIteration(); }
@@ -113,7 +126,7 @@ struct LocalBackendHandle : public BackendHandle {
  * Handle for integrated library backend.
  */
 struct IntegratedBackendHandle : public LocalBackendHandle {
-    IntegratedBackendHandle(const Context& _context) {
+    IntegratedBackendHandle(const Context& _context): LocalBackendHandle(_context) {
         backend.reset(new mori::BasicBackend(_context));
     }
 };  // struct IntegratedBackendHandle
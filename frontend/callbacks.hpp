@@ -3,7 +3,11 @@
 namespace mori {
 
 enum struct CallbackStage {
-    postSwapIn, postSwapOut
+    postSwapIn, postSwapOut,
+    // Re-run the producer operator of the dropped tensor, writing to the device address given.
+    // Mori does not track the inputs of the producer. The inputs should be made resident before the dropped tensor is waited, and should not be dropped.
+    // The callback runs with the tensors of the waiting request locked, hence it must not re-enter the memory session.
+    recompute
 };  // enum struct CallbackStage
 
 using Callback  = std::function<int(const std::string&, void*)>;
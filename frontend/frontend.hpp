@@ -196,6 +196,7 @@ protected:
 
         virtual void start() override {
             frontend.backend_handle->submitMemoryStatus(frontend.memory_status);
+            frontend.memory_status.setConcurrent(true);
 
             frontend.executor.init();
             frontend.backend_handle->start();
@@ -258,13 +259,20 @@ protected:
         }
         virtual bool isInited() const noexcept override { return true; }
 
+        // Registration while started is published to the backend immediately as a status delta, so that the events of the new tensors and operators can be resolved.
         virtual void registerTensor(const status::Tensor& tensor) override {
-            (*frontend.logger) << LogLevel::error << "Registering tensor " << tensor.getName() << " while frontend started." << endl;
-            throw inited_exception();
+            TensorId id = frontend.memory_status.registerTensor(tensor);
+            status::MemoryStatusDelta delta;
+            delta.registered_tensors.push_back(frontend.memory_status.referenceConstTensor(id).get());
+            frontend.backend_handle->submitMemoryStatusDelta(delta);
+            (*frontend.logger) << LogLevel::debug << "Tensor " << tensor.getName() << " registered while frontend started." << endl;
         }
         virtual void registerOperator(const status::Operator& operator_status) override {
-            (*frontend.logger) << LogLevel::error << "Registering operator " << operator_status.getName() << " while frontend started." << endl;
-            throw inited_exception();
+            OperatorId id = frontend.memory_status.registerOperator(operator_status);
+            status::MemoryStatusDelta delta;
+            delta.registered_operators.push_back(frontend.memory_status.referenceConstOperator(id).get());
+            frontend.backend_handle->submitMemoryStatusDelta(delta);
+            (*frontend.logger) << LogLevel::debug << "Operator " << operator_status.getName() << " registered while frontend started." << endl;
         }
 
         // virtual void updateOperator(const std::string& op, const status::Tensor& tensor_status) {
@@ -306,18 +314,28 @@ protected:
         }
 
         virtual void unregisterTensor(const std::string& tensor) override {
-            (*frontend.logger) << LogLevel::error << "Unregistering tensor " << tensor << " while frontend not initialized." << endl;
-            throw uninited_exception();
+            // The memory regions of the tensor are recorded in the layout, hence the tensor should be freed first.
+            if (frontend.memory_status.referenceConstTensor(tensor).isMemoryLocated()) throw status_exception("Tensor not freed.");
+            frontend.memory_status.unregisterTensor(tensor);
+            status::MemoryStatusDelta delta;
+            delta.unregistered_tensors.push_back(tensor);
+            frontend.backend_handle->submitMemoryStatusDelta(delta);
+            (*frontend.logger) << LogLevel::debug << "Tensor " << tensor << " unregistered while frontend started." << endl;
         }
 
         virtual void unregisterOperator(const std::string& op) override {
-            (*frontend.logger) << LogLevel::error << "Unregistering operator " << op << " while frontend not initialized." << endl;
-            throw uninited_exception();
+            frontend.memory_status.unregisterOperator(op);
+            status::MemoryStatusDelta delta;
+            delta.unregistered_operators.push_back(op);
+            frontend.backend_handle->submitMemoryStatusDelta(delta);
+            (*frontend.logger) << LogLevel::debug << "Operator " << op << " unregistered while frontend started." << endl;
         }
 
         virtual void stop() override {
             frontend.executor.terminate();
             frontend.backend_handle->stop();
+            frontend.memory_status.setConcurrent(false);
+            frontend.memory_status.reclaim();
             frontend.impl = &frontend.inited_impl;
         }
 
@@ -23,7 +23,7 @@ protected:
 
         MemoryRegion region = layout.getMemoryRegion(src);
 
-        status::TensorView tensor_view = status.tryReferenceTensor(region.name); 
+        status::TensorView tensor_view = status.tryReferenceTensor(region.tensor); 
         if (!tensor_view.isReferenced()) return;     // Cannot move this tensor
         status::TensorPres tensor_pres =  tensor_view.reference();
 
@@ -40,7 +40,7 @@ protected:
             memory_manager->copyDevice(src, dst, size);
             memory_manager->freeDevice(src);
 
-            layout.recordMemoryAllocateEvent(dst, size, tensor_pres.getName());
+            layout.recordMemoryAllocateEvent(dst, size, tensor_pres.getId());
             layout.recordMemoryFreeEvent(src);
 
             allocated_regions[size].insert(dst);
@@ -57,7 +57,7 @@ protected:
             void* right = memory_manager->split(dst, size);
             memory_manager->freeDevice(right);
 
-            layout.recordMemoryAllocateEvent(dst, utils::address_distance(src, dst), tensor_pres.getName());
+            layout.recordMemoryAllocateEvent(dst, utils::address_distance(src, dst), tensor_pres.getId());
             layout.recordMemoryMergeEvent(dst, src);
             layout.recordMemorySplitEvent(dst, size);
             layout.recordMemoryFreeEvent(right);
@@ -10,6 +10,14 @@ public:
     virtual void* allocateDevice(size_t size) = 0;
     virtual void* allocateHost(size_t size) = 0;
     virtual void* allocate(size_t size) { return allocateDevice(size); }
+    /**
+     * Allocate on a specific device. Managers of multiple devices should override this method.
+     * Device 0 is the primary device.
+     */
+    virtual void* allocateDevice(DeviceId device, size_t size) {
+        if (device == 0) return allocateDevice(size);
+        return nullptr;
+    }
 
     virtual void copyIn(void* host_address, void* device_address, size_t size) = 0;
     virtual void copyOut(void* device_address, void* host_address, size_t size) = 0;
@@ -40,6 +48,11 @@ public:
         copyIn(host_address, dst, size);
         freeHost(host_address);
     }
+    /**
+     * Copy between devices. The owning devices are identified by the addresses.
+     * Managers with peer access should override this method to avoid the bounce via host memory.
+     */
+    virtual void copyPeer(void* src, void* dst, size_t size) { copyDevice(src, dst, size); }
     virtual void* split(void* address, size_t size) { return nullptr; }
     virtual void* salloc(void* address, size_t size) { return nullptr; }
     virtual bool  merge(void* left, void* right) { return false; }
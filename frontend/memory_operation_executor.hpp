@@ -36,9 +36,9 @@ private:
                 case status::MemoryStatusType::host: {
                     void *device_address = nullptr;
                     // Allocate this section
-                    device_address = executor.memory_manager->allocateDevice(section.size);
+                    device_address = executor.memory_manager->allocateDevice(tensor.getDevice(), section.size);
                     if (device_address == nullptr) throw memory_device_insufficience("Device memory insufficient.", section.size);
-                    executor.layout.recordMemoryAllocateEvent(device_address, section.size, tensor.getName());
+                    executor.layout.recordMemoryAllocateEvent(device_address, section.size, tensor.getId());
                     // if (tensor.hasFragment()) {
                     //     memory_manager->split(device_address, section->size);
                     //     tensor.setFragmentPlaced((uint8_t*)device_address + section->size);
@@ -121,14 +121,14 @@ private:
     struct MemoryOperationExecutorSectionedImpl final : public MemoryOperationExecutorImpl {
     protected:
         void relocate(status::TensorPres& tensor) {
-            void* device_address = executor.memory_manager->allocateDevice(tensor.getSize());
+            void* device_address = executor.memory_manager->allocateDevice(tensor.getDevice(), tensor.getSize());
             if (device_address == nullptr) {
                 if (tensor.getDeviceSize() != 0) executor.swapOut(tensor, tensor.getDeviceSize());
                 assert(!tensor.isDeviceLocated());
-                device_address = executor.memory_manager->allocateDevice(tensor.getSize());
+                device_address = executor.memory_manager->allocateDevice(tensor.getDevice(), tensor.getSize());
                 if (device_address == nullptr) throw memory_device_insufficience("Relocation of tensor failed.", tensor.getSize());
             }
-            executor.layout.recordMemoryAllocateEvent(device_address, tensor.getSize(), tensor.getName());
+            executor.layout.recordMemoryAllocateEvent(device_address, tensor.getSize(), tensor.getId());
             // Remove fragment
             if (tensor.hasFragment()) {
                 const status::Fragment& fragment = tensor.getFragment();
@@ -205,7 +205,7 @@ private:
                             return;
                         }
                         // Salloc do not need aligned allcoation.
-                        executor.layout.recordMemoryAllocateEvent(device_address, section->size, tensor.getName(), 1);
+                        executor.layout.recordMemoryAllocateEvent(device_address, section->size, tensor.getId(), 1);
                         assert(device_address == section->device_address);
 
                         // Less possible to happen since copying in usually takes place in backward propagation, while the peak memory usage is gone through.
@@ -255,7 +255,8 @@ private:
                         if (copied_size + section->size > size) {
                             executor.memory_manager->split(section->device_address, size - copied_size);
                             executor.layout.recordMemorySplitEvent(section->device_address, size - copied_size);
-                            tensor.split(section->offset, size - copied_size);
+                            // Splitting may relocate the sections.
+                            section = &(tensor.split(section->offset, size - copied_size));
                         }
 
                         void* host_address = executor.memory_manager->allocateHost(section->size);
@@ -348,7 +349,7 @@ private:
             void* target_address = (uint8_t*)(tensor.getFirstSection().device_address) + tensor.getSize();
             void* device_address = executor.memory_manager->salloc(target_address, tensor.getFragment().size);
             if (device_address == nullptr) throw memory_exception("Allocation for fragment failed.");
-            executor.layout.recordMemoryAllocateEvent(device_address, tensor.getFragment().size, tensor.getName(), 1);
+            executor.layout.recordMemoryAllocateEvent(device_address, tensor.getFragment().size, tensor.getId(), 1);
             tensor.setFragmentPlaced();
         }
         virtual void fuse(status::TensorPres& tensor) override {
@@ -380,7 +381,7 @@ public:
     // void allocate(status::TensorPres& tensor) {        
     //     void* device_address = memory_manager->allocate(tensor.getSize() + tensor.getFragment().size);
     //     if (device_address == nullptr) throw memory_device_insufficience("Device memory insufficient.", tensor.getSize());
-    //     layout.recordMemoryAllocateEvent(device_address, tensor.getSize() + tensor.getFragment().size, tensor.getName());
+    //     layout.recordMemoryAllocateEvent(device_address, tensor.getSize() + tensor.getFragment().size, tensor.getId());
     //     tensor.setAllocated(device_address);
     // }
 
@@ -446,6 +447,38 @@ public:
         freeDevice(tensor, size);
     }
 
+    /**
+     * Drop the whole tensor data on device without copying out, since the recomputation regenerates the whole tensor. The data is recomputed when accessed.
+     * Tensors with data on host are freed on device as the data is preserved.
+     * @param tensor Tensor to be dropped
+    */
+    void drop(status::TensorPres& tensor) {
+        if (tensor.isHostLocated()) return freeDevice(tensor, tensor.getSize());
+
+        tensor.setDropped(true);
+        // Free the sections only located on device as well, which freeDevice keeps for copying out.
+        const status::MemorySection* section = &(tensor.getFirstSection());
+        while (section != nullptr) {
+            switch (section->status) {
+                case status::MemoryStatusType::device:
+                case status::MemoryStatusType::empty:
+                    layout.recordMemoryFreeEvent(section->device_address);
+                    memory_manager->freeDevice(section->device_address);
+                    tensor.setDeviceFreed(section->offset);
+                default:
+                    break;
+            }
+            section = section->next();
+        }
+        while (tensor.isMergeable(0)) tensor.merge(0);
+
+        if (tensor.hasFragment() && tensor.getFragment().status == status::MemoryStatusType::empty) {
+            layout.recordMemoryFreeEvent(tensor.getFragment().address);
+            memory_manager->freeDevice(tensor.getFragment().address);
+            tensor.setFragmentRemoved();
+        }
+    }
+
     /**
      * Free device and host memory with specific size.
      * Free from the first section that located on device or host
@@ -457,6 +490,38 @@ public:
         freeHost(tensor, size);
     }
 
+    /**
+     * Move tensor data to another device, as an alternative of swapping out when the peer has free capacity.
+     * Only tensors with a single section located on device can be moved.
+     * @param tensor Tensor to be moved
+     * @param device Target device
+     * @return if the tensor is located on the target device
+    */
+    bool migrate(status::TensorPres& tensor, DeviceId device) {
+        if (tensor.getSectionCount() != 1 || tensor.hasFragment()) return false;
+        const status::MemorySection& section = tensor.getFirstSection();
+        switch (section.status) {
+            case status::MemoryStatusType::empty:
+            case status::MemoryStatusType::device:
+            case status::MemoryStatusType::coexist:
+                break;
+            default:
+                return false;
+        }
+        void* src_address = section.device_address;
+        if (layout.getDeviceId(src_address) == device) return true;
+
+        void* dst_address = memory_manager->allocateDevice(device, section.size);
+        if (dst_address == nullptr) return false;
+        layout.recordMemoryAllocateEvent(dst_address, section.size, tensor.getId());
+        // Empty data does not need copying.
+        if (section.status != status::MemoryStatusType::empty) memory_manager->copyPeer(src_address, dst_address, section.size);
+        layout.recordMemoryFreeEvent(src_address);
+        memory_manager->freeDevice(src_address);
+        tensor.setMoved(section.offset, dst_address);
+        return true;
+    }
+
     /**
      * Place fragment for the tensor
      * @param tensor Tensor to be placed fragment
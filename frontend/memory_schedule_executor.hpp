@@ -17,6 +17,16 @@ namespace mori {
 struct BackendHandle;
 
 struct MemoryScheduleExecutor final {
+protected:
+    /**
+     * Schedule events of a stage, with tensor and operator handles resolved.
+     */
+    struct StageEvents final {
+        // Execution-triggered events, indexed by the handle of the operator after which they are triggered.
+        std::vector<std::vector<events::ScheduleEvent>> execution;
+        std::vector<events::ScheduleEvent> timepoint;
+    };  // inner struct StageEvents
+
 protected:
     Context context;
     status::MemoryStatus& status;
@@ -27,14 +37,15 @@ protected:
     
     // Schedule information
     std::shared_mutex events_m;
-    events::StageScheduleEvents forward_schedule_events;
-    events::StageScheduleEvents backward_schedule_events;
-    std::atomic<events::StageScheduleEvents*> current_eventset;
+    StageEvents forward_schedule_events;
+    StageEvents backward_schedule_events;
+    std::atomic<StageEvents*> current_eventset;
     std::shared_mutex events_mutex;
 
     std::mutex new_events_m;
     std::atomic<bool> events_updated = false;
-    events::ScheduleEvents new_events;
+    StageEvents new_forward_schedule_events;
+    StageEvents new_backward_schedule_events;
 
     // Executor thread
     std::thread executor_thread;
@@ -65,7 +76,7 @@ protected:
     std::atomic<bool> inited = false;
 
     // Time-triggered events require these methods to reset the schedule timepoint offset.
-    inline long getExecutionTimepoint() { return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - current_time_offset).count(); }
+    inline long getExecutionTimepoint() { return utils::get_duration_val(std::chrono::steady_clock::now() - current_time_offset); }
     inline void resetExecution() {
         std::unique_lock<std::mutex> queue_lock{queue_m};
         activated_events.clear();
@@ -98,11 +109,46 @@ protected:
         }
     }
 
+    /**
+     * Resolve the handles of the schedule events. Events of unregistered tensors are dropped.
+     */
+    StageEvents resolveScheduleEvents(const events::StageScheduleEvents& eventset) const {
+        auto resolve = [this](events::ScheduleEvent event, std::vector<events::ScheduleEvent>& target) {
+            if (!status.isTensorRegistered(event.tensor_name)) return;
+            event.tensor_id = status.getTensorId(event.tensor_name);
+            if (status.isOperatorRegistered(event.operator_name)) event.operator_id = status.getOperatorId(event.operator_name);
+            target.push_back(std::move(event));
+        };
+
+        StageEvents re;
+        for (auto &x : eventset.execution) {
+            if (!status.isOperatorRegistered(x.first)) continue;
+            OperatorId op = status.getOperatorId(x.first);
+            if (re.execution.size() <= op) re.execution.resize(op + 1);
+            for (auto &y : x.second) resolve(y, re.execution[op]);
+        }
+        for (auto &x : eventset.timepoint) resolve(x, re.timepoint);
+        return re;
+    }
+
     bool executeEvent(const events::ScheduleEvent& event) {
-        status::TensorView tensor_view = status.tryReferenceTensor(event.tensor_name);
+        status::TensorView tensor_view = status.tryReferenceTensor(event.tensor_id);
         if (!tensor_view.isReferenced()) return false;
         status::TensorPres tensor_pres = tensor_view.reference();
 
+        // Account the data transferred between device and host.
+        size_t transferring_size = 0;
+        switch (event.type) {
+            case events::ScheduleEventType::copyin:
+            case events::ScheduleEventType::copyout:
+            case events::ScheduleEventType::swapin:
+            case events::ScheduleEventType::swapout:
+                transferring_size = event.size;
+            default:
+                break;
+        }
+        status::MemoryAccounting::Transferring transferring(status.getAccounting(), event.tensor_id, transferring_size);
+
         switch (event.type) {
             case events::ScheduleEventType::copyin:
                 // No data to copy in.
@@ -151,6 +197,20 @@ protected:
                     if (!tensor_pres.isMemoryLocated()) break;
                     executor.free(tensor_pres, event.size);
                     break;
+                case events::ScheduleEventType::recompute:
+                    // No data to drop.
+                    if (!tensor_pres.isDeviceLocated()) break;
+                    // The data cannot be recomputed without the framework, hence swapped out instead.
+                    if (!callbacks.count(CallbackStage::recompute)) {
+                        if (tensor_pres.isHostAllLocated()) break;
+                        executor.swapOut(tensor_pres, event.size);
+                        if (callbacks.count(CallbackStage::postSwapOut)) callbacks.at(CallbackStage::postSwapOut)(event.tensor_name, tensor_pres.getSection(0).host_address);
+                        (*logger) << LogLevel::debug << "Operator " << event.operator_name << ": tensor " << event.tensor_name << " swapped out. (Instant)" << endl;
+                        break;
+                    }
+                    executor.drop(tensor_pres);
+                    (*logger) << LogLevel::debug << "Operator " << event.operator_name << ": tensor " << event.tensor_name << " dropped. (Instant)" << endl;
+                    break;
                 default:
                     break;
             }
@@ -206,8 +266,8 @@ public:
                         std::unique_lock<std::shared_mutex> em_n{events_m};
                         std::unique_lock<std::mutex> nem{new_events_m};
 
-                        this->forward_schedule_events  = std::move(this->new_events.forward_schedule_events);
-                        this->backward_schedule_events = std::move(this->new_events.backward_schedule_events);
+                        this->forward_schedule_events  = std::move(this->new_forward_schedule_events);
+                        this->backward_schedule_events = std::move(this->new_backward_schedule_events);
                         logger->submit(LogLevel::debug, "Memory schedule executor switches to new schedule event set.");
                         events_updated = false;
                     }
@@ -265,27 +325,31 @@ public:
     }
 
     void updateSchedule(const events::ScheduleEvents& _new_events) {
+        // Names are resolved once here, hence the executor only works with handles.
+        StageEvents forward_events  = resolveScheduleEvents(_new_events.forward_schedule_events);
+        StageEvents backward_events = resolveScheduleEvents(_new_events.backward_schedule_events);
+
         std::unique_lock<std::mutex> l{new_events_m};
-        this->new_events = _new_events;
-        events_updated = true;
-    }
-    void updateSchedule(events::ScheduleEvents&& _new_events) {
-        std::unique_lock<std::mutex> l{new_events_m};
-        this->new_events = std::move(_new_events);
+        this->new_forward_schedule_events  = std::move(forward_events);
+        this->new_backward_schedule_events = std::move(backward_events);
         events_updated = true;
     }
 
-    void setOperatorStarted(const std::string& op) {}
+    void setOperatorStarted(OperatorId op) {}
+    inline void setOperatorStarted(const std::string& op) { setOperatorStarted(status.getOperatorId(op)); }
 
-    void setOperatorFinished(const std::string& op) {
+    void setOperatorFinished(OperatorId op) {
         next_op_sync = false;
+        std::vector<std::vector<events::ScheduleEvent>>& execution = current_eventset.load()->execution;
+        if (op >= execution.size()) return;
         std::unique_lock<std::mutex> ql{queue_m};
-        for (auto &x : current_eventset.load()->execution[op]) {
+        for (auto &x : execution[op]) {
             if (x.instant) executeEvent(x);
             else activated_events.push_back(x);
         }
         // logger->submit(LogLevel::debug, "Memory schedule executor moves to next operator.");
     }
+    inline void setOperatorFinished(const std::string& op) { setOperatorFinished(status.getOperatorId(op)); }
 
     int getIteration() { return iteration; }
     void setIteration(int _iteration) { iteration = _iteration; }
@@ -32,76 +32,233 @@ public:
         MemorySession& session;
 
     private:
-        std::string op;
+        OperatorId op;
 
         ApplicationStage stage;
 
-        std::unordered_map<std::string, status::TensorPres> requested_tensors;
+        std::unordered_map<TensorId, status::TensorPres> requested_tensors;
         std::atomic<bool> waiting = true;
         std::atomic<bool> executing = false;
 
         /**
          * isTensorWaited
          * Check if tensor has been selected and waited.
-         * @param tensor tensor name
+         * @param tensor tensor handle
          * @return if the tensor has been selected and waited.
          */
-        bool isTensorWaited(const std::string& tensor) {
+        bool isTensorWaited(TensorId tensor) {
             return requested_tensors.find(tensor) != requested_tensors.end();
         }
 
-        Request(MemorySession& _session, const std::string& _op, ApplicationStage _stage): session(_session), op(_op), stage(_stage) {}
+        Request(MemorySession& _session, OperatorId _op, ApplicationStage _stage): session(_session), op(_op), stage(_stage) {}
 
     public:
         Request(const Request&) = delete;
         Request(Request&& _request): session(_request.session) {
-            op = std::move(_request.op);
+            op = _request.op;
             stage = _request.stage;
         }
 
-        void waitTensor(const std::string& tensor) {
+    private:
+        /**
+         * copyIn
+         * Copy in the data of the tensor not located on device.
+         * @return if the tensor is all located on device, false if device memory insufficient
+         */
+        bool copyIn(status::TensorPres& pres) {
+            // Dropped data is not transferred, but recomputed after the memory allocated.
+            bool dropped = pres.isDropped();
+            status::MemoryAccounting::Transferring transferring(session.status.getAccounting(), pres.getId(), dropped ? 0 : session.getAcquiringSize(pres));
+            // Data parked on a peer device is moved back to the owning device.
+            if (pres.isDeviceAllLocated()) return session.op_executor.migrate(pres, pres.getDevice());
+            try {
+                session.op_executor.copyIn(pres, pres.getSize() - pres.getDeviceSize());
+            } catch(memory_device_insufficience& e) {
+                return false;
+            }
+            if (dropped) recompute(pres);
+            return true;
+        }
+
+        /**
+         * recompute
+         * Regenerate the dropped data by the recompute callback, after the device memory allocated.
+         * The tensor stays locked, since the allocated memory is not filled until the callback returns. Hence the callback must not re-enter the session, see CallbackStage::recompute.
+         */
+        void recompute(status::TensorPres& pres) {
+            std::string tensor_name = session.status.getTensorName(pres.getId());
+            if (!session.callbacks.count(CallbackStage::recompute)) throw status_exception("Recomputing tensor without callback.");
+            recomputing = true;
+            try {
+                session.callbacks.at(CallbackStage::recompute)(tensor_name, pres.getSection(0).device_address);
+            } catch (...) {
+                recomputing = false;
+                throw;
+            }
+            recomputing = false;
+            pres.setDropped(false);
+            (*session.logger) << LogLevel::debug << "Operator: " << session.status.getOperatorName(op) << ", tensor: " << tensor_name << " recomputed. (Memory access)" << endl;
+            session.backend_handle.lock()->submitEvent(events::MemoryEvent(op, pres.getId(), pres.getSize(), events::MemoryEventType::recompute, stage));
+        }
+
+        void submitSwappedIn(TensorId tensor, status::TensorPres& pres, size_t acquiring_size, long stall) {
+            std::string tensor_name = session.status.getTensorName(tensor);
+            if (session.callbacks.count(CallbackStage::postSwapIn)) session.callbacks.at(CallbackStage::postSwapIn)(tensor_name, pres.getSection(0).device_address);
+            (*session.logger) << LogLevel::debug << "Operator: " << session.status.getOperatorName(op) << ", tensor: " << tensor_name << " swapped in. (Memory access)" << endl;
+            session.backend_handle.lock()->submitEvent(events::MemoryEvent(op, tensor, acquiring_size, events::MemoryEventType::swapin, stage, stall));
+        }
+
+        /**
+         * submitTransferWaited
+         * The tensor was locked by the transferring in flight, and became resident with no data acquired by the session.
+         * Reported with the time waited, apart from the swapping of the session.
+         */
+        void submitTransferWaited(TensorId tensor, long stall) {
+            if (stall <= 0) return;
+            session.backend_handle.lock()->submitEvent(events::MemoryEvent(op, tensor, 0, events::MemoryEventType::wait, stage, stall));
+        }
+
+        static inline long getStall(const std::chrono::steady_clock::time_point& waiting_timepoint) {
+            return utils::get_duration_val(std::chrono::steady_clock::now() - waiting_timepoint);
+        }
+
+        /**
+         * lockTensor
+         * Reference the tensor for the request.
+         * @param stall time waited for the lock if the tensor is being transferred, otherwise 0.
+         */
+        status::TensorPres& lockTensor(TensorId tensor, long& stall) {
+            stall = 0;
+            status::TensorView view = session.status.tryReferenceTensor(tensor);
+            if (view.isReferenced()) return requested_tensors.emplace(tensor, view.reference()).first->second;
+
+            auto locking_timepoint = std::chrono::steady_clock::now();
+            bool transferring = session.status.getAccounting().isTransferring(tensor);
+            auto p = requested_tensors.emplace(tensor, view.reference());
+            if (transferring) stall = getStall(locking_timepoint);
+            return p.first->second;
+        }
+
+        /**
+         * releaseAbove
+         * Release the tensors held by the request with handles above the contended tensor, so that waiting for it keeps the ascending order of handles.
+         * @return the released tensors, to be waited again
+         */
+        std::vector<TensorId> releaseAbove(TensorId tensor) {
+            std::vector<TensorId> re;
+            for (auto p = requested_tensors.begin(); p != requested_tensors.end(); ) {
+                if (p->first <= tensor) { ++p; continue; }
+                re.push_back(p->first);
+                p = requested_tensors.erase(p);
+            }
+            return re;
+        }
+
+    public:
+        void waitTensor(TensorId tensor) {
             if (!waiting) throw uninited_exception();
             if (executing) throw inited_exception();
 
             // If the tensor waited, it would have been locked on device memory.
             if (isTensorWaited(tensor)) return;
 
-            auto p = requested_tensors.emplace(tensor, session.status.referenceTensor(tensor));
-            status::TensorPres& pres = p.first->second;
+            auto waiting_timepoint = std::chrono::steady_clock::now();
+            long locking_stall = 0;
+            status::TensorPres& pres = lockTensor(tensor, locking_stall);
             // Do not swap in tensor that already on device.
-            if (pres.isDeviceAllLocated()) return;
+            if (session.isTensorResident(pres)) {
+                submitTransferWaited(tensor, locking_stall);
+                return;
+            }
             
-            size_t acquiring_size = pres.getSize() - pres.getDeviceSize();
-            try {
-                session.op_executor.copyIn(pres, pres.getSize() - pres.getDeviceSize());
-            } catch(memory_device_insufficience& e) {
+            size_t acquiring_size = session.getAcquiringSize(pres);
+            bool dropped = pres.isDropped();
+            if (!copyIn(pres)) {
                 // Memory on device not insufficience.
-                size_t released_size = session.waitMemory(pres.getSize(), [this, &pres]() {
-                    try {
-                        session.op_executor.copyIn(pres, pres.getSize() - pres.getDeviceSize());
-                    } catch(memory_device_insufficience& e) {
-                        return false;
-                    }
-                    return true;
-                });
-                if (!pres.isDeviceAllLocated()) throw e;
+                session.waitMemory(pres.getSize(), [this, &pres]() { return copyIn(pres); }, pres.getDevice());
+                if (!session.isTensorResident(pres)) throw memory_device_insufficience("Device memory insufficient.", acquiring_size);
             }
-            assert(pres.isDeviceAllLocated());
+            assert(session.isTensorResident(pres));
 
-            if (session.callbacks.count(CallbackStage::postSwapIn)) session.callbacks.at(CallbackStage::postSwapIn)(tensor, pres.getSection(0).device_address);
-            (*session.logger) << LogLevel::debug << "Operator: " << op << ", tensor: " << tensor << " swapped in. (Memory access)" << endl;
-            session.backend_handle.lock()->submitEvent(events::MemoryEvent(op, tensor, acquiring_size, events::MemoryEventType::swapin, stage));
+            if (!dropped) submitSwappedIn(tensor, pres, acquiring_size, getStall(waiting_timepoint));
         }
+        inline void waitTensor(const std::string& tensor) { waitTensor(session.status.getTensorId(tensor)); }
 
-        // /**
-        //  * waitOperator
-        //  * Wait all the tensors of an operator to be located in device memory.
-        //  * @param op operator to be waited
-        //  */
-        // void waitOperator(const std::string& op) {
-        //     for (auto &s : status.)
-        //         waitTensor(x.first, x.second);
-        // }
+        /**
+         * waitOperator
+         * Wait all the tensors of an operator to be located in device memory.
+         * The tensors are locked in ascending order of their handles, and the missing data is copied in with at most one memory releasing pass.
+         * The tensors already held by the request take part in the order. A tensor below a held one is only tried; if contended, the held tensors above it are released and waited again.
+         * @param target operator handle
+         */
+        void waitOperator(OperatorId target) {
+            if (!waiting) throw uninited_exception();
+            if (executing) throw inited_exception();
+
+            std::vector<TensorId> tensors;
+            for (TensorId tensor : session.status.referenceConstOperator(target).getTensorIds()) {
+                if (!isTensorWaited(tensor)) tensors.push_back(tensor);
+            }
+            std::sort(tensors.begin(), tensors.end());
+
+            // Lock the tensors and calculate the missing data.
+            std::vector<std::pair<TensorId, size_t>> acquiring;
+            std::unordered_set<TensorId> dropped;
+            size_t acquiring_size = 0;
+            auto waiting_timepoint = std::chrono::steady_clock::now();
+            for (size_t i = 0; i < tensors.size(); ++i) {
+                TensorId tensor = tensors[i];
+                long locking_stall = 0;
+                bool ordered = std::all_of(requested_tensors.begin(), requested_tensors.end(), [tensor](const auto& x) { return x.first < tensor; });
+                if (!ordered) {
+                    status::TensorView view = session.status.tryReferenceTensor(tensor);
+                    if (view.isReferenced()) requested_tensors.emplace(tensor, view.reference());
+                    else {
+                        std::vector<TensorId> released = releaseAbove(tensor);
+                        tensors.insert(tensors.end(), released.begin(), released.end());
+                        std::sort(tensors.begin() + i + 1, tensors.end());
+                    }
+                }
+                status::TensorPres& pres = isTensorWaited(tensor) ? requested_tensors.at(tensor) : lockTensor(tensor, locking_stall);
+                if (session.isTensorResident(pres)) {
+                    submitTransferWaited(tensor, locking_stall);
+                    continue;
+                }
+                acquiring.emplace_back(tensor, session.getAcquiringSize(pres));
+                if (pres.isDropped()) dropped.insert(tensor);
+                acquiring_size += acquiring.back().second;
+            }
+            if (acquiring.empty()) return;
+
+            auto copy_in_all = [this, &acquiring]() {
+                for (auto &x : acquiring) {
+                    status::TensorPres& pres = requested_tensors.at(x.first);
+                    if (session.isTensorResident(pres)) continue;
+                    if (!copyIn(pres)) return false;
+                }
+                return true;
+            };
+
+            if (!copy_in_all()) {
+                // Release memory for all the remaining data at once, per owning device.
+                std::map<DeviceId, size_t> remaining_sizes;
+                for (auto &x : acquiring) {
+                    status::TensorPres& pres = requested_tensors.at(x.first);
+                    if (!session.isTensorResident(pres)) remaining_sizes[pres.getDevice()] += session.getAcquiringSize(pres);
+                }
+                for (auto &x : remaining_sizes) session.waitMemory(x.second, copy_in_all, x.first);
+                for (auto &x : acquiring) {
+                    if (!session.isTensorResident(requested_tensors.at(x.first))) throw memory_device_insufficience("Device memory insufficient.", acquiring_size);
+                }
+            }
+
+            // The tensors are waited together, hence share the stall.
+            long stall = getStall(waiting_timepoint);
+            for (auto &x : acquiring) {
+                if (dropped.count(x.first) == 0) submitSwappedIn(x.first, requested_tensors.at(x.first), x.second, stall);
+            }
+        }
+        inline void waitOperator(const std::string& target) { waitOperator(session.status.getOperatorId(target)); }
 
         void setOperationStarted() {
             if (!waiting) throw uninited_exception();
@@ -117,10 +274,9 @@ public:
          * setMemoryDataAssigned
          * Set the memory data is assigned, or written.
          * The operator name should be provided since the outputs of the prev operators may be accessed.
-         * @param op operator name
-         * @param tensor tensor name
+         * @param tensor tensor handle
          */
-        void setMemoryDataAssigned(const std::string& tensor) {
+        void setMemoryDataAssigned(TensorId tensor) {
             if (!waiting) throw uninited_exception();
             if (executing) throw inited_exception();
             if (!isTensorWaited(tensor)) throw status_exception("Tensor not waited.");
@@ -135,15 +291,15 @@ public:
             // emit memory event
             session.backend_handle.lock()->submitEvent(events::MemoryEvent(op, tensor, pres.getSize() ,events::MemoryEventType::write, stage));
         }
+        inline void setMemoryDataAssigned(const std::string& tensor) { setMemoryDataAssigned(session.status.getTensorId(tensor)); }
 
         /**
          * setMemoryDataAcquired
          * Set the memory data is acquired, or read.
          * The operator name should be provided since the outputs of the prev operators may be accessed.
-         * @param op operator name
-         * @param tensor tensor name
+         * @param tensor tensor handle
          */
-        void setMemoryDataAcquired(const std::string& tensor) {
+        void setMemoryDataAcquired(TensorId tensor) {
             if (!waiting) throw uninited_exception();
             if (executing) throw inited_exception();
             if (!isTensorWaited(tensor)) throw status_exception("Operator or tensor not waited.");
@@ -154,14 +310,15 @@ public:
             // emit memory event
             session.backend_handle.lock()->submitEvent(events::MemoryEvent(op, tensor, pres.getSize(), events::MemoryEventType::read, stage));
         }
+        inline void setMemoryDataAcquired(const std::string& tensor) { setMemoryDataAcquired(session.status.getTensorId(tensor)); }
 
         /**
          * setMemoryDataAccessed
          * Set the memory data is accessed.
          * The operator name should be provided since the outputs of the prev operators may be accessed.
-         * @param tensor tensor name
+         * @param tensor tensor handle
          */
-        void setMemoryDataAccessed(const std::string& tensor) {
+        void setMemoryDataAccessed(TensorId tensor) {
             if (!waiting) throw uninited_exception();
             if (executing) throw inited_exception();
             if (!isTensorWaited(tensor)) throw status_exception("Tensor not waited.");
@@ -174,6 +331,7 @@ public:
             // emit memory event
             session.backend_handle.lock()->submitEvent(events::MemoryEvent(op, tensor, pres.getSize(), events::MemoryEventType::access, stage));
         }
+        inline void setMemoryDataAccessed(const std::string& tensor) { setMemoryDataAccessed(session.status.getTensorId(tensor)); }
 
         void setOperationFinished() {
             if (!waiting) throw uninited_exception();
@@ -221,6 +379,9 @@ private:
 
     ApplicationStage stage = ApplicationStage::forward;
 
+    // If a recompute callback runs on this thread. Re-entering would wait for the tensors locked by the request, or the executor synchronized by waitMemory.
+    static inline thread_local bool recomputing = false;
+
     void setBackendHandle(const std::weak_ptr<BackendHandle>& _backend_handle) {
         backend_handle = _backend_handle;
     }
@@ -237,11 +398,45 @@ private:
         callbacks.emplace(stage, callback);
     }
 
-    size_t waitTensorMemory(size_t size, const std::string& initial_tensor) {
-        std::string tensor_name = initial_tensor;
+    /**
+     * @brief Check if the tensor is all located on its owning device.
+     */
+    bool isTensorResident(const status::TensorPres& pres) const {
+        if (!pres.isDeviceAllLocated()) return false;
+        if (layout.getDeviceCount() == 1) return true;
+        return layout.getDeviceId(pres.getFirstSection().device_address) == pres.getDevice();
+    }
+
+    /**
+     * @brief Size of data to be placed on the owning device, including the data parked on a peer device.
+     */
+    size_t getAcquiringSize(const status::TensorPres& pres) const {
+        if (pres.isDeviceAllLocated()) return isTensorResident(pres) ? 0 : pres.getSize();
+        return pres.getSize() - pres.getDeviceSize();
+    }
+
+    /**
+     * @brief Move the tensor to a peer device with enough free memory, which is cheaper than swapping out to host.
+     * @return if the tensor is moved
+     */
+    bool migrateToPeer(status::TensorPres& pres, DeviceId device) {
+        for (DeviceId peer = 0; peer < layout.getDeviceCount(); ++peer) {
+            if (peer == device) continue;
+            try {
+                if (!layout.isFreeRegionExist(layout::MemoryBlockType::common, pres.getDeviceSize(), peer)) continue;
+            } catch (memory_unmanaged& e) {
+                continue;
+            }
+            if (op_executor.migrate(pres, peer)) return true;
+        }
+        return false;
+    }
+
+    size_t waitTensorMemory(size_t size, TensorId initial_tensor, DeviceId device) {
+        TensorId tensor = initial_tensor;
         while (true) {
             // Since the memory schedule executor is synchronized, a tensor that cannot be referenced must be waited by memory session.
-            status::TensorView tensor_view = status.tryReferenceTensor(tensor_name);
+            status::TensorView tensor_view = status.tryReferenceTensor(tensor);
             if (!tensor_view.isReferenced()) return 0;
             status::TensorPres tensor_pres = tensor_view.reference();
             // Do not swap out tensors that already host-only.
@@ -249,6 +444,8 @@ private:
             uint8_t *device_address_e = (uint8_t *)(tensor_pres.getLastSection().device_address);
             // // Do not swap out persistent or transient tensors.
             if (!layout.isCommon(device_address_e)) return 0;
+            // Only the memory of the demanding device helps.
+            if (layout.getDeviceCount() > 1 && layout.getDeviceId(device_address_e) != device) return 0;
 
             // Prepare to swap out this tensor.
             // Step 1: Locate the first section on device.
@@ -276,19 +473,25 @@ private:
             size_t releasing_size = releasing_b;
             if (releasing_size + avail_size > size) releasing_size = size - avail_size;
             // If partically swap tensor, reserve aligned size
-            assert(utils::get_memory_aligned_size(releasing_size, memory_info.device.align_size) >= releasing_size);
-            size_t releasing_alignment_size = utils::get_memory_aligned_size(releasing_size, memory_info.device.align_size) - releasing_size;
+            assert(utils::get_memory_aligned_size(releasing_size, memory_info.getDevice(device).align_size) >= releasing_size);
+            size_t releasing_alignment_size = utils::get_memory_aligned_size(releasing_size, memory_info.getDevice(device).align_size) - releasing_size;
             if (releasing_size + releasing_alignment_size <= tensor_pres.getDeviceSize()) releasing_size += releasing_alignment_size;
             else releasing_alignment_size = 0;
-            op_executor.swapOut(tensor_pres, releasing_size);
-            size_t releasing_e = tensor_pres.getDeviceSize();
-            if (tensor_pres.getFragment().status == status::MemoryStatusType::empty) releasing_e += tensor_pres.getFragment().size;
-
-            std::string op_name = tensor_pres.getOperatorName();
-            if (callbacks.count(CallbackStage::postSwapOut)) callbacks.at(CallbackStage::postSwapOut)(tensor_name, tensor_pres.getSection(0).host_address);
-            (*logger) << LogLevel::debug << "Operator " << op_name << ": tensor " << tensor_name << " swapped out. (Memory insufficience)" << endl;
+            bool migrated = layout.getDeviceCount() > 1 && migrateToPeer(tensor_pres, device);
+            if (migrated) releasing_alignment_size = 0;
+            else op_executor.swapOut(tensor_pres, releasing_size);
+            size_t releasing_e = migrated ? 0 : tensor_pres.getDeviceSize();
+            if (!migrated && tensor_pres.getFragment().status == status::MemoryStatusType::empty) releasing_e += tensor_pres.getFragment().size;
+
+            std::string tensor_name = status.getTensorName(tensor);
+            if (migrated) {
+                (*logger) << LogLevel::debug << "Operator " << tensor_pres.getOperatorName() << ": tensor " << tensor_name << " moved to device " << layout.getDeviceId(tensor_pres.getFirstSection().device_address) << ". (Memory insufficience)" << endl;
+            } else {
+                if (callbacks.count(CallbackStage::postSwapOut)) callbacks.at(CallbackStage::postSwapOut)(tensor_name, tensor_pres.getSection(0).host_address);
+                (*logger) << LogLevel::debug << "Operator " << tensor_pres.getOperatorName() << ": tensor " << tensor_name << " swapped out. (Memory insufficience)" << endl;
+            }
 
-            backend_handle.lock()->submitEvent(events::MemoryEvent(op_name, tensor_name, releasing_b - releasing_e, events::MemoryEventType::swapout, stage));
+            backend_handle.lock()->submitEvent(events::MemoryEvent(tensor_pres.getOperatorId(), tensor, releasing_b - releasing_e, events::MemoryEventType::swapout, stage));
 
             assert(releasing_b >= (releasing_e + releasing_alignment_size));
             avail_size = avail_size + releasing_b - releasing_e - releasing_alignment_size;
@@ -306,14 +509,27 @@ private:
                 if (!layout.isRegionExist(device_address_e)) return avail_size;
                 region = layout.getMemoryRegion(device_address_e);
             }
-            tensor_name = region.name;
+            tensor = region.tensor;
         }
         return 0;
     }
 
+    /**
+     * @brief Resolve the handle of an operator. Memory events may be submitted without operator, or with an unregistered one.
+     * @param op operator name
+     * @return operator handle, or invalid_id if the operator is not registered
+     */
+    inline OperatorId resolveOperator(const std::string& op) const { return status.isOperatorRegistered(op) ? status.getOperatorId(op) : invalid_id; }
+
 public:
     MemorySession(const Context& _context, MemoryScheduleExecutor& _executor, status::MemoryStatus& _status, layout::MemoryLayout& _layout): context(_context), status(_status), layout(_layout), sch_executor(_executor),  op_executor(_layout), defrag_executor(_status, _layout) {}
 
+    /**
+     * @brief Handles of the registered tensors and operators. The handles are stable during the session, hence should be cached by the caller.
+     */
+    inline TensorId   getTensorId(const std::string& tensor) const { return status.getTensorId(tensor); }
+    inline OperatorId getOperatorId(const std::string& op)   const { return status.getOperatorId(op); }
+
     int getIteration() const { return 0; }
     
     void setIteration(int iteration) {
@@ -330,7 +546,12 @@ public:
         stage = ApplicationStage::forward;
 
         sch_executor.newIteration();
-        backend_handle.lock()->newIteration();
+        auto backend = backend_handle.lock();
+        // Fragmentation of the finished iteration.
+        backend->submitLayoutStatistics(layout.getStatistics());
+        backend->newIteration();
+        // Iteration boundary is the quiescent point of status lookups.
+        status.reclaim();
 
         (*logger) << LogLevel::info << "Iteration: " << sch_executor.getIteration() << endl;
     }
@@ -353,74 +574,81 @@ public:
 
     /**
      * @brief Set the memory data has dynamic shape and size changed.
-     * @param op operator name
-     * @param tensor tensor name
+     * @param op operator handle
+     * @param tensor tensor handle
      * @param size dynamic shape size
      */
-    void setMemoryDataReshaped(const std::string& op, const std::string& tensor, size_t size) {
-        if (!status.isTensorRegistered(tensor)) throw status_exception("Tensor not registered.");
-
+    void setMemoryDataReshaped(OperatorId op, TensorId tensor, size_t size) {
         status::TensorPres pres = status.referenceTensor(tensor);
         pres.setReshaped(size);
 
         // emit memory event
         backend_handle.lock()->submitEvent(events::MemoryEvent(op, tensor, pres.getSize(), events::MemoryEventType::reshape, stage));
     }
+    inline void setMemoryDataReshaped(const std::string& op, const std::string& tensor, size_t size) { setMemoryDataReshaped(resolveOperator(op), status.getTensorId(tensor), size); }
 
     /**
      * @brief Set the memory data is allocated.
-     * @param op operator name
-     * @param tensor tensor name
+     * @param op operator handle
+     * @param tensor tensor handle
      * @param address tensor address
      */
-    void setMemoryDataAllocated(const std::string& op, const std::string& tensor, void* address) {
-        if (!status.isTensorRegistered(tensor)) throw status_exception("Tensor not registered.");
-
+    void setMemoryDataAllocated(OperatorId op, TensorId tensor, void* address) {
         status::TensorPres pres = status.referenceTensor(tensor);
+        // Tensors are owned by the device where they are allocated.
+        if (layout.getDeviceCount() > 1) pres.setDevice(layout.getDeviceId(address));
         pres.setAllocated(address);
         if (pres.hasFragment()) op_executor.fragment(pres);
 
-        layout.recordMemoryAllocateEvent(address, pres.getSize(), tensor);
+        layout.recordMemoryAllocateEvent(address, pres.getSize(), pres.getId());
         // if (layout.isTransient(address)) defrag_executor.recordMemoryAllocateEvent(address);
 
         // emit memory event
         backend_handle.lock()->submitEvent(events::MemoryEvent(op, tensor, pres.getSize(), events::MemoryEventType::allocate, stage));
     }
 
-    void setMemoryDataAllocated(const std::string& tensor, void* address) { setMemoryDataAllocated("", tensor, address); }
+    inline void setMemoryDataAllocated(const std::string& op, const std::string& tensor, void* address) { setMemoryDataAllocated(resolveOperator(op), status.getTensorId(tensor), address); }
+    inline void setMemoryDataAllocated(TensorId tensor, void* address) { setMemoryDataAllocated(invalid_id, tensor, address); }
+    inline void setMemoryDataAllocated(const std::string& tensor, void* address) { setMemoryDataAllocated("", tensor, address); }
 
     /**
      * @brief  Assure the data of a operator is moved to the device memory before the operator is launched.
      * @return MemoryRequest object
      */
-    Request createRequest(const std::string& op = "") {
-        // if (!status.isOperatorRegistered(op)) throw status_exception("Operator not registered.");
+    Request createRequest(OperatorId op) {
+        if (recomputing) throw status_exception("Requesting in recompute callback.");
         Request re(*this, op, stage);
         return re;
     }
+    inline Request createRequest(const std::string& op = "") {
+        // if (!status.isOperatorRegistered(op)) throw status_exception("Operator not registered.");
+        return createRequest(resolveOperator(op));
+    }
 
     /**
      * @brief Wait for available memory. Memory insufficent is an emergency event, hence an independent method is provided.
      * @param size Memory size that should be released.
+     * @param device Device where the memory is demanded.
      * @return Memory size released.
      * @note Currently this method adopts a FIFO strategy that the firstly forward-propagating operator will be firstly released. 
      */
-    size_t waitMemory(size_t size, const MemoryFunction& func = []() { return false; }) {
+    size_t waitMemory(size_t size, const MemoryFunction& func = []() { return false; }, DeviceId device = 0) {
+        if (recomputing) throw status_exception("Waiting memory in recompute callback.");
         utils::Presentation<MemoryScheduleExecutor> presentation(sch_executor);
         presentation.require();
         if (func()) return size;
 
         size_t avail_size = 0;
         for (auto &op_name : status.getExecutionOrder()) {
-            status::OperatorView op_view = status.tryReferenceOperator(op_name);
+            status::ConstOperatorView op_view = status.tryReferenceConstOperator(op_name);
             if (!op_view.isReferenced()) continue;
-            status::OperatorPres op_pres = op_view.reference();
+            status::ConstOperatorPres op_pres = op_view.reference();
             // Forward propagation and backward propagation share the same set of tensors.
             // if (op_pres.isBackwardPropagation()) continue;
 
-            for (auto &s : op_pres.getTensors()) { 
+            for (TensorId tensor : op_pres.getTensorIds()) { 
                 // Try to release memory from tensors.
-                avail_size = waitTensorMemory(size, s);
+                avail_size = waitTensorMemory(size, tensor, device);
                 if (avail_size >= size) break;
             }
             if (avail_size >= size) break;
@@ -440,12 +668,10 @@ public:
 
     /**
      * @brief Set the memory data is freed.
-     * @param op operator name
-     * @param tensor tensor name
+     * @param op operator handle
+     * @param tensor tensor handle
      */
-    void setMemoryDataFreed(const std::string& op, const std::string& tensor) {
-        if (!status.isTensorRegistered(tensor)) throw status_exception("Operator or tensor not registered.");
-        
+    void setMemoryDataFreed(OperatorId op, TensorId tensor) {
         status::TensorPres pres = status.referenceTensor(tensor);
         op_executor.freeHost(pres, pres.getHostSize());
         const status::MemorySection* section = (&pres.getFirstSection());
@@ -468,7 +694,7 @@ public:
 
             if (pres.isMergeable(section->offset)) pres.merge(section->offset);
             const status::MemorySection* section_prev = section->prev();
-            if (section_prev != nullptr && pres.isMergeable(section_prev->offset)) section = &(pres.merge(section->offset));
+            if (section_prev != nullptr && pres.isMergeable(section_prev->offset)) section = &(pres.merge(section_prev->offset));
 
             section = section->next();
         } while (section != nullptr);
@@ -480,7 +706,9 @@ public:
         backend_handle.lock()->submitEvent(events::MemoryEvent(op, tensor, pres.getSize(), events::MemoryEventType::free, stage));
     }
 
-    void setMemoryDataFreed(const std::string& tensor) { setMemoryDataFreed("", tensor); }
+    inline void setMemoryDataFreed(const std::string& op, const std::string& tensor) { setMemoryDataFreed(resolveOperator(op), status.getTensorId(tensor)); }
+    inline void setMemoryDataFreed(TensorId tensor) { setMemoryDataFreed(invalid_id, tensor); }
+    inline void setMemoryDataFreed(const std::string& tensor) { setMemoryDataFreed("", tensor); }
 
     ~MemorySession() = default;
 };  // struct MemorySession
@@ -12,6 +12,10 @@ struct Backend {
     virtual void init() = 0;
 
     virtual void submitMemoryStatus(const status::MemoryStatus& status) = 0;
+    /**
+     * Registrations and unregistrations after the status is submitted.
+     */
+    virtual void submitMemoryStatusDelta(const status::MemoryStatusDelta& delta) = 0;
 
     virtual void start() {}
 
@@ -21,6 +25,10 @@ struct Backend {
 
     virtual void submitEvent(const events::MemoryEvent& event) = 0;
     virtual void submitEvent(const events::ExecutionEvent& event) = 0;
+    /**
+     * Fragmentation statistics of the memory layout, submitted at iteration boundaries.
+     */
+    virtual void submitLayoutStatistics(const std::vector<layout::BlockStatistics>&) {}
     virtual events::ScheduleEvents getScheduleEvents() = 0;
 
     virtual void stop() {}
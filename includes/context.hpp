@@ -49,9 +49,31 @@ protected:
         defaults.emplace("scheduler", "section");
         defaults.emplace("scheduler.dependency.timeaware", "true");
         defaults.emplace("scheduler.dependency.thershold", "2");
+        // Target slack of prefetching in microseconds, kept by the dependency-aware scheduler. Stall within the tolerance is ignored.
+        defaults.emplace("scheduler.dependency.slack", "0");
+        defaults.emplace("scheduler.dependency.slack.tolerance", "100");
+        // Rebuild the schedule when regression measured over the window of recent iterations. If the retention of events is bounded, it should cover the window.
+        // The schedule is withdrawn for the next iteration, which is profiled to rebuild the schedule.
+        defaults.emplace("scheduler.replan", "false");
+        defaults.emplace("scheduler.replan.window", "2");
+        // Regression of the stall, relative to the average of the window, and the least growth in microseconds.
+        defaults.emplace("scheduler.replan.stall", "0.5");
+        defaults.emplace("scheduler.replan.stall.floor", "1000");
+        // Quantization units of memory sizes in the knapsack of the optimal scheduler.
+        defaults.emplace("scheduler.optimal.resolution", "4096");
+
+        // Events of all the iterations are retained by default. A bounded retention keeps the latest iterations, plus the pinned ones (e.g., the profiling iteration 1).
+        defaults.emplace("events.retention", "0");
+        defaults.emplace("events.retention.pinned", "");
+        // Log every submitted event. Enabling it formats a debug entry per event on the training thread.
+        defaults.emplace("events.log", "false");
+        // Ingest the events on a background worker of the integrated backend, instead of on the training thread.
+        defaults.emplace("events.async", "true");
 
         defaults.emplace("exporters.events", "empty");
         defaults.emplace("exporters.events.method", "empty");
+        // Binary event log of the "binary" events exporter, replayable with mori::events::EventReplayer.
+        defaults.emplace("exporters.events.filename", "events.mlog");
         defaults.emplace("exporters.tensors", "empty");
         defaults.emplace("exporters.tensors.method", "empty");
         defaults.emplace("exporters.schedule", "empty");
@@ -26,27 +26,31 @@ namespace utils {
     }
 }   // namespace utils
 
+/**
+ * ExecutionEvent
+ * Operators are referred by their handles in MemoryStatus. Names are resolved on export.
+ */
 struct ExecutionEvent {
-    std::string op;
+    OperatorId op;
     ExecutionEventType type;
     ApplicationStage   stage;
     std::chrono::steady_clock::time_point timestamp;
 
     ExecutionEvent() {
-        op = "";
+        op = invalid_id;
         type = ExecutionEventType::execution;
         stage = ApplicationStage::all;
         timestamp = std::chrono::steady_clock::now();
     }
 
-    ExecutionEvent(const std::string& _op, ExecutionEventType _type, ApplicationStage _stage, const std::chrono::steady_clock::time_point& _timestamp) {
+    ExecutionEvent(OperatorId _op, ExecutionEventType _type, ApplicationStage _stage, const std::chrono::steady_clock::time_point& _timestamp) {
         op = _op;
         type = _type;
         stage = _stage;
         timestamp = _timestamp;
     }
 
-    ExecutionEvent(const std::string& _op, ExecutionEventType _type, ApplicationStage _stage) {
+    ExecutionEvent(OperatorId _op, ExecutionEventType _type, ApplicationStage _stage) {
         op = _op;
         type = _type;
         stage = _stage;
@@ -60,7 +64,7 @@ struct ExecutionEvent {
 
     operator std::string() const {
         std::stringstream ss;
-        ss<<"Timestamp: "<<mori::utils::get_timestamp_val(timestamp)<<" operator: "<<op<<" type: "<<utils::get_event_type_str(type)<<" stage: "<<mori::utils::get_application_stage_str(stage);
+        ss<<"Timestamp: "<<mori::utils::get_timestamp_val(timestamp)<<" operator: "<<mori::utils::get_id_str(op)<<" type: "<<utils::get_event_type_str(type)<<" stage: "<<mori::utils::get_application_stage_str(stage);
         return ss.str();
     }
 };  // struct ExecutionEvent
@@ -13,7 +13,7 @@ namespace mori {
 namespace events {
 
 enum struct MemoryEventType {
-    allocate, write, read, access, swapin, swapout, free, reshape
+    allocate, write, read, access, swapin, swapout, free, reshape, recompute, wait
 };  // enum struct MemoryEventType
 
 namespace utils {
@@ -35,6 +35,10 @@ namespace utils {
                 return "free";
             case MemoryEventType::reshape:
                 return "reshape";
+            case MemoryEventType::recompute:
+                return "recompute";
+            case MemoryEventType::wait:
+                return "wait";
         }
 
         assert(0);
@@ -42,39 +46,47 @@ namespace utils {
     }
 }   // namespace utils
 
+/**
+ * MemoryEvent
+ * Tensors and operators are referred by their handles in MemoryStatus. Names are resolved on export.
+ */
 struct MemoryEvent final {
-    std::string op;
-    std::string tensor;
+    OperatorId op;
+    TensorId tensor;
     size_t size;
     MemoryEventType type;
     ApplicationStage stage;
     std::chrono::steady_clock::time_point timestamp;
+    long stall;     // Time the training thread waited for the memory, in microseconds.
 
     MemoryEvent() {
-        op = "";
-        tensor = "";
+        op = invalid_id;
+        tensor = invalid_id;
         size = 0;
         type = MemoryEventType::access;
         stage = ApplicationStage::all;
         timestamp = std::chrono::steady_clock::now();
+        stall = 0;
     }
 
-    MemoryEvent(const std::string& _op, const std::string& _tensor, size_t _size, MemoryEventType _type, ApplicationStage _stage, const std::chrono::steady_clock::time_point& _timestamp) {
+    MemoryEvent(OperatorId _op, TensorId _tensor, size_t _size, MemoryEventType _type, ApplicationStage _stage, const std::chrono::steady_clock::time_point& _timestamp, long _stall = 0) {
         op = _op;
         tensor = _tensor;
         size = _size;
         type = _type;
         stage = _stage;
         timestamp = _timestamp;
+        stall = _stall;
     }
 
-    MemoryEvent(const std::string& _op, const std::string& _tensor, size_t _size, MemoryEventType _type, ApplicationStage _stage) {
+    MemoryEvent(OperatorId _op, TensorId _tensor, size_t _size, MemoryEventType _type, ApplicationStage _stage, long _stall = 0) {
         op = _op;
         tensor = _tensor;
         size = _size;
         type = _type;
         stage = _stage;
         timestamp = std::chrono::steady_clock::now();
+        stall = _stall;
     } 
 
     MemoryEvent(const MemoryEvent& event) = default;
@@ -84,7 +96,7 @@ struct MemoryEvent final {
 
     operator std::string() const {
         std::stringstream ss;
-        ss<<"Timestamp: "<<mori::utils::get_timestamp_val(timestamp)<<" operator: "<<op<<" tensor: "<<tensor<<" size: "<<size<<" type: "<<utils::get_event_type_str(type)<<" stage: "<<mori::utils::get_application_stage_str(stage);
+        ss<<"Timestamp: "<<mori::utils::get_timestamp_val(timestamp)<<" operator: "<<mori::utils::get_id_str(op)<<" tensor: "<<mori::utils::get_id_str(tensor)<<" size: "<<size<<" type: "<<utils::get_event_type_str(type)<<" stage: "<<mori::utils::get_application_stage_str(stage);
         return ss.str();
     }
 
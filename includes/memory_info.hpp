@@ -1,6 +1,9 @@
 #pragma once
 
 #include <string>
+#include <vector>
+
+#include "includes/symbols.hpp"
 
 namespace mori {
 
@@ -48,8 +51,16 @@ public:
     };  // innter struct Host
 
 public:
+    // Primary device.
     Device device;
+    // Peer devices in the same process, with device ids starting from 1.
+    std::vector<Device> peers;
     Host   host;
+
+public:
+    inline size_t getDeviceCount() const noexcept { return peers.size() + 1; }
+    inline const Device& getDevice(DeviceId id) const { return id == 0 ? device : peers.at(id - 1); }
+    inline Device& getDevice(DeviceId id) { return id == 0 ? device : peers.at(id - 1); }
 };  // struct MemoryInfo
 
 static MemoryInfo create_default_memory_info(size_t device, size_t host) {
@@ -4,6 +4,8 @@
 #include <vector>
 #include <map>
 #include <set>
+#include <algorithm>
+#include <iterator>
 #include <unordered_map>
 #include <unordered_set>
 #include <shared_mutex>
@@ -164,7 +166,7 @@ enum struct MemoryBlockType {
 };  // enum struct MemoryBlockType
 
 struct MemoryRegion final {
-    std::string name = "";  // Tensor information
+    TensorId tensor = invalid_id;  // Tensor information
 
     void* address = nullptr;
     size_t size = 0;
@@ -172,29 +174,107 @@ struct MemoryRegion final {
     bool allocated = false;
 };  // struct MemoryRegion
 
+/**
+ * Fragmentation statistics of a memory block.
+ */
+struct BlockStatistics final {
+    MemoryBlockType type;
+    DeviceId device = 0;
+    size_t total_size = 0;
+    size_t free_size = 0;
+    size_t largest_free_size = 0;
+    size_t free_region_count = 0;
+
+    /**
+     * External fragmentation, the portion of free memory not in the largest free region.
+     * 0 means the free memory is contiguous.
+     */
+    inline double getFragmentation() const {
+        if (free_size == 0) return 0.0;
+        return 1.0 - (double)largest_free_size / free_size;
+    }
+};  // struct BlockStatistics
+
 struct Block final {
+    // Region records are pooled, so that steady-state bookkeeping does not reach the global heap.
+    using RegionMap     = std::map<void*, MemoryRegion, std::less<void*>, utils::PoolAllocator<std::pair<void* const, MemoryRegion>>>;
+    using FreeRegionSet = std::set<std::pair<size_t, void*>, std::less<std::pair<size_t, void*>>, utils::PoolAllocator<std::pair<size_t, void*>>>;
+
     MemoryBlockType type;
-    std::map<void*, MemoryRegion> regions;
+    DeviceId device;
+    RegionMap regions;
+    // Unallocated regions ordered by size and address.
+    FreeRegionSet free_regions;
     mutable std::shared_mutex m;
     size_t total_size;
+    size_t free_size;
 
-    Block(MemoryBlockType block_type, void* address, size_t size) {
+    Block(MemoryBlockType block_type, DeviceId block_device, void* address, size_t size) {
         type = block_type;
+        device = block_device;
         total_size = size;
         MemoryRegion s;
         s.address = address;
         s.size    = size;
         regions.emplace(s.address, s);
+        free_regions.emplace(s.size, s.address);
+        free_size = size;
     }
     Block(const Block& block) {
         type    = block.type;
+        device  = block.device;
         regions = block.regions;
+        free_regions = block.free_regions;
         total_size = block.total_size;
+        free_size  = block.free_size;
     }
     Block(Block&& block) {
         type    = block.type;
+        device  = block.device;
         regions = std::move(block.regions);
+        free_regions = std::move(block.free_regions);
         total_size = block.total_size;
+        free_size  = block.free_size;
+    }
+
+    /**
+     * Locate the region which covers the address.
+     * @return iterator to the region, or regions.end() if not exists.
+     */
+    inline RegionMap::iterator locateRegion(void* address) {
+        auto p = regions.upper_bound(address);
+        if (p == regions.begin()) return regions.end();
+        --p;
+        if (utils::address_offset(p->first, p->second.size) <= address) return regions.end();
+        return p;
+    }
+
+    inline void indexFreeRegion(const MemoryRegion& region) {
+        free_regions.emplace(region.size, region.address);
+        free_size += region.size;
+    }
+    inline void unindexFreeRegion(const MemoryRegion& region) {
+        free_regions.erase(std::make_pair(region.size, region.address));
+        free_size -= region.size;
+    }
+
+    inline BlockStatistics getStatistics() const {
+        BlockStatistics re;
+        re.type = type;
+        re.device = device;
+        re.total_size = total_size;
+        re.free_size  = free_size;
+        re.free_region_count = free_regions.size();
+        if (!free_regions.empty()) re.largest_free_size = free_regions.rbegin()->first;
+        return re;
+    }
+
+    /**
+     * Smallest unallocated region not smaller than size.
+     * @return iterator to the free region index, or free_regions.end() if not exists.
+     */
+    inline FreeRegionSet::const_iterator locateBestFitRegion(size_t size) const {
+        return free_regions.lower_bound(std::make_pair(size, static_cast<void*>(nullptr)));
     }
 };  // struct Block
 
@@ -205,12 +285,37 @@ private:
     friend struct MemoryDefragmentationExecutor;
 
 private:
+    /**
+     * Entry of the block table.
+     * Block boundaries and types are fixed after setMemoryInfo, hence classification requires no lock.
+     */
+    struct BlockEntry final {
+        void* address;
+        size_t size;
+        MemoryBlockType type;
+        DeviceId device;
+        size_t align_size;
+    };  // struct BlockEntry
+
+private:
+    // Blocks of all the devices. The devices are assumed to share an unified address space.
     std::map<void*, Block> blocks;
-    // std::shared_mutex m;
+    // Immutable after setMemoryInfo, sorted by address.
+    std::vector<BlockEntry> block_table;
 
-    size_t align_size;
+    size_t device_count = 1;
 
 protected:
+    /**
+     * Locate the block entry whose range starts at or before the address.
+     */
+    inline const BlockEntry& locateBlockEntry(void* address) const {
+        if (address == nullptr) throw memory_address_invalid();
+        auto bp = std::upper_bound(block_table.begin(), block_table.end(), address, [](void* target, const BlockEntry& entry) { return target < entry.address; });
+        if (bp == block_table.begin()) throw memory_unmanaged();
+        return *std::prev(bp);
+    }
+
     inline std::map<void*, Block>::const_iterator locateMemoryBlock(void* address) const {
         auto bp = blocks.upper_bound(address);
         if (bp == blocks.begin()) return blocks.cend();
@@ -221,6 +326,9 @@ protected:
         if (bp == blocks.begin()) return blocks.end();
         return std::prev(bp);
     }
+    inline std::map<void*, Block>::const_iterator locateMemoryBlock(MemoryBlockType type, DeviceId device) const {
+        return std::find_if(blocks.begin(), blocks.end(), [type, device](const std::pair<void* const, Block>& p) { return p.second.type == type && p.second.device == device; });
+    }
 
 public:
     MemoryLayout() = default;
@@ -228,17 +336,34 @@ public:
     inline void setMemoryInfo(const MemoryInfo& info) {
         assert(blocks.empty());
 
-        blocks.emplace(info.device.common_block.address,     Block(MemoryBlockType::common,     info.device.common_block.address,     info.device.common_block.size));
-        blocks.emplace(info.device.persistent_block.address, Block(MemoryBlockType::persistent, info.device.persistent_block.address, info.device.persistent_block.size));
-        blocks.emplace(info.device.transient_block.address,  Block(MemoryBlockType::transient,  info.device.transient_block.address,  info.device.transient_block.size));
-
-        align_size  = info.device.align_size;
+        device_count = info.getDeviceCount();
+        for (DeviceId id = 0; id < device_count; ++id) {
+            const MemoryInfo::Device& device = info.getDevice(id);
+            auto emplace_block = [&](MemoryBlockType type, const MemoryInfo::Block& block) {
+                // Blocks not configured are absent.
+                if (block.size == 0) return;
+                blocks.emplace(block.address, Block(type, id, block.address, block.size));
+                block_table.push_back(BlockEntry{block.address, block.size, type, id, device.align_size});
+            };
+            emplace_block(MemoryBlockType::common,     device.common_block);
+            emplace_block(MemoryBlockType::persistent, device.persistent_block);
+            emplace_block(MemoryBlockType::transient,  device.transient_block);
+        }
+        std::sort(block_table.begin(), block_table.end(), [](const BlockEntry& a, const BlockEntry& b) { return a.address < b.address; });
     }
 
+    inline size_t getDeviceCount() const noexcept { return device_count; }
+    /**
+     * Device owning the address.
+     */
+    inline DeviceId getDeviceId(void* address) const { return locateBlockEntry(address).device; }
+
     bool isRegionExist(void* address, Direction direction = Direction::post) const {
         if (address == nullptr) throw memory_address_invalid();
         auto bp = locateMemoryBlock(address);
         if (bp == blocks.end()) return false;
+        // Addresses beyond the block can not be region heads.
+        if (direction == Direction::post && utils::address_offset(bp->first, bp->second.total_size) <= address) return false;
         std::shared_lock<std::shared_mutex> l{bp->second.m};
         auto& regions = bp->second.regions;
         if (direction == Direction::post) return regions.find(address) != regions.end();
@@ -260,45 +385,28 @@ public:
         }
     }
 
-    bool isPersistent(void* address) const {
-        if (address == nullptr) throw memory_address_invalid();
-        auto bp = locateMemoryBlock(address);
-        if (bp == blocks.end()) throw memory_unmanaged();
-        std::shared_lock<std::shared_mutex> l{bp->second.m};
-        return bp->second.type == MemoryBlockType::persistent;
-    }
-    bool isTransient(void* address) const {
-        if (address == nullptr) throw memory_address_invalid();
-        auto bp = locateMemoryBlock(address);
-        if (bp == blocks.end()) throw memory_unmanaged();
-        std::shared_lock<std::shared_mutex> l{bp->second.m};
-        return bp->second.type == MemoryBlockType::transient;
-    }
-    bool isCommon(void* address) const {
-        if (address == nullptr) throw memory_address_invalid();
-        auto bp = locateMemoryBlock(address);
-        if (bp == blocks.end()) throw memory_unmanaged();
-        std::shared_lock<std::shared_mutex> l{bp->second.m};
-        return bp->second.type == MemoryBlockType::common;
-    }
+    inline MemoryBlockType getBlockType(void* address) const { return locateBlockEntry(address).type; }
+    inline bool isPersistent(void* address) const { return getBlockType(address) == MemoryBlockType::persistent; }
+    inline bool isTransient(void* address)  const { return getBlockType(address) == MemoryBlockType::transient; }
+    inline bool isCommon(void* address)     const { return getBlockType(address) == MemoryBlockType::common; }
 
-    void recordMemoryAllocateEvent(void* address, size_t size, const std::string& tensor, size_t alignment) {
+    void recordMemoryAllocateEvent(void* address, size_t size, TensorId tensor, size_t alignment) {
         if (address == nullptr) throw memory_address_invalid();
         // Since MemoryLayout is only a recorder of memory layout information, no need to implement for malloc and salloc seperately.
         if (size == 0) return recordMemoryAllocateEvent(address, alignment, tensor, alignment);
 
-        auto bp = blocks.upper_bound(address);
-        assert(bp != blocks.begin());
-        --bp;
+        auto bp = locateMemoryBlock(address);
+        if (bp == blocks.end()) throw memory_unmanaged();
 
         std::unique_lock<std::shared_mutex> l{bp->second.m};
-        auto& regions = bp->second.regions;
-        auto p = regions.begin();
-        while (p != regions.end() && utils::address_offset(p->first, p->second.size) <= address) ++p;
-        if (p == regions.end() || p->first > address || p->second.allocated) throw memory_allocated(address);
+        Block& block = bp->second;
+        auto& regions = block.regions;
+        auto p = block.locateRegion(address);
+        if (p == regions.end() || p->second.allocated) throw memory_allocated(address);
         if (utils::address_offset(p->first, p->second.size) < utils::address_offset(address, size)) throw memory_operation_invalid(address, "Memory cannot be allocated at specificied address with size.");
 
         // The original unallocated space should be splited to three parts.
+        block.unindexFreeRegion(p->second);
         if (p->first < address) {
             // Left part exists.
             MemoryRegion s;
@@ -307,6 +415,7 @@ public:
             auto q = regions.emplace(address, s);
             assert(q.second);
             p->second.size = (uint8_t*)address - (uint8_t*)p->first;
+            block.indexFreeRegion(p->second);
             p = q.first;
         }
         // Now p->first == address
@@ -318,13 +427,15 @@ public:
             s.size    = p->second.size - size;
             auto q = regions.emplace(s.address, s);
             assert(q.second);
+            block.indexFreeRegion(s);
             p->second.size = size;
         }
-        p->second.name      = tensor;
+        p->second.tensor    = tensor;
         p->second.allocated = true;
     }
-    void recordMemoryAllocateEvent(void* address, size_t size, const std::string& tensor) {
+    void recordMemoryAllocateEvent(void* address, size_t size, TensorId tensor) {
         if (address == nullptr) throw memory_address_invalid();
+        size_t align_size = locateBlockEntry(address).align_size;
         if (!utils::memory_address_aligned(address, align_size)) throw memory_exception(address, "Memory address not aligned.");
         size_t aligned_size = utils::get_memory_aligned_size(size, align_size);
         if (aligned_size == 0) aligned_size = align_size;
@@ -336,29 +447,102 @@ public:
         if (bp == blocks.end()) throw memory_not_allocated(address);
 
         std::unique_lock<std::shared_mutex> l{bp->second.m};
-        auto& regions = bp->second.regions;
+        Block& block = bp->second;
+        auto& regions = block.regions;
         // Check if allocated device memory.
         auto p = regions.find(address);
         // Device memory not allocated.
         if (p == regions.end() || !p->second.allocated) throw memory_not_allocated(address);
-        p->second.name      = "";
+        p->second.tensor    = invalid_id;
         p->second.allocated = false;
 
         // Merging free regions.
-        auto prev = p;
-        auto post = p;
-        ++post;
+        auto post = std::next(p);
         if (post != regions.end() && !post->second.allocated) {
+            block.unindexFreeRegion(post->second);
             p->second.size += post->second.size;
             regions.erase(post);
         }
 
-        if (p == regions.begin()) return;
-        --prev;
-        if (!prev->second.allocated) {
-            prev->second.size += p->second.size;
-            regions.erase(p);
+        if (p != regions.begin()) {
+            auto prev = std::prev(p);
+            if (!prev->second.allocated) {
+                block.unindexFreeRegion(prev->second);
+                prev->second.size += p->second.size;
+                regions.erase(p);
+                p = prev;
+            }
         }
+        block.indexFreeRegion(p->second);
+    }
+
+    /**
+     * isFreeRegionExist
+     * Check if an unallocated region not smaller than size exists in the block.
+     */
+    bool isFreeRegionExist(MemoryBlockType type, size_t size, DeviceId device = 0) const {
+        auto bp = locateMemoryBlock(type, device);
+        if (bp == blocks.end()) throw memory_unmanaged();
+        std::shared_lock<std::shared_mutex> l{bp->second.m};
+        return bp->second.locateBestFitRegion(size) != bp->second.free_regions.end();
+    }
+
+    /**
+     * getBestFitRegion
+     * Smallest unallocated region not smaller than size in the block.
+     */
+    MemoryRegion getBestFitRegion(MemoryBlockType type, size_t size, DeviceId device = 0) const {
+        auto bp = locateMemoryBlock(type, device);
+        if (bp == blocks.end()) throw memory_unmanaged();
+        std::shared_lock<std::shared_mutex> l{bp->second.m};
+        auto p = bp->second.locateBestFitRegion(size);
+        if (p == bp->second.free_regions.end()) throw memory_device_insufficience("No unallocated region fits.", size);
+        return bp->second.regions.at(p->second);
+    }
+
+    /**
+     * getLargestFreeRegion
+     * Largest unallocated region in the block. The size is 0 if the block is fully allocated.
+     */
+    MemoryRegion getLargestFreeRegion(MemoryBlockType type, DeviceId device = 0) const {
+        auto bp = locateMemoryBlock(type, device);
+        if (bp == blocks.end()) throw memory_unmanaged();
+        std::shared_lock<std::shared_mutex> l{bp->second.m};
+        if (bp->second.free_regions.empty()) return MemoryRegion();
+        return bp->second.regions.at(bp->second.free_regions.rbegin()->second);
+    }
+
+    /**
+     * getLargestFreeRegions
+     * At most k largest unallocated regions in the block, in descending order of size.
+     */
+    std::vector<MemoryRegion> getLargestFreeRegions(MemoryBlockType type, size_t k, DeviceId device = 0) const {
+        auto bp = locateMemoryBlock(type, device);
+        if (bp == blocks.end()) throw memory_unmanaged();
+        std::shared_lock<std::shared_mutex> l{bp->second.m};
+        std::vector<MemoryRegion> re;
+        for (auto p = bp->second.free_regions.rbegin(); p != bp->second.free_regions.rend() && re.size() < k; ++p) re.push_back(bp->second.regions.at(p->second));
+        return re;
+    }
+
+    BlockStatistics getStatistics(MemoryBlockType type, DeviceId device = 0) const {
+        auto bp = locateMemoryBlock(type, device);
+        if (bp == blocks.end()) throw memory_unmanaged();
+        std::shared_lock<std::shared_mutex> l{bp->second.m};
+        return bp->second.getStatistics();
+    }
+
+    /**
+     * getStatistics
+     * Fragmentation statistics of all the blocks, in ascending order of block address.
+     */
+    std::vector<BlockStatistics> getStatistics() const {
+        std::vector<BlockStatistics> re;
+        for (auto& x : blocks) {
+            std::shared_lock<std::shared_mutex> l{x.second.m};
+            re.push_back(x.second.getStatistics());
+        }
+        return re;
     }
     void recordMemorySplitEvent(void* address, size_t size) {
         if (address == nullptr) throw memory_address_invalid();
@@ -397,4 +581,20 @@ public:
 };  // struct MemoryLayout
 
 }   // namespace layout
+
+namespace utils {
+    static std::string get_memory_block_type_str(layout::MemoryBlockType type) {
+        switch (type) {
+            case layout::MemoryBlockType::common:
+                return "common";
+            case layout::MemoryBlockType::persistent:
+                return "persistent";
+            case layout::MemoryBlockType::transient:
+                return "transient";
+            default:
+                return "";
+        }
+    }
+}   // namespace utils
+
 }   // namespace mori
\ No newline at end of file
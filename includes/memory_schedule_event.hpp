@@ -5,6 +5,7 @@
 #include <string>
 #include <sstream>
 
+#include "includes/symbols.hpp"
 #include "includes/memory_layout.hpp"
 
 namespace mori {
@@ -15,7 +16,8 @@ enum struct ScheduleEventType {
     copyin, copyout, 
     swapin, swapout, 
     freedev, freehost, 
-    free
+    free,
+    recompute   // Drop the data on device, which is recomputed by re-running the producer operator when accessed.
 };  // enum struct ScheduleEventType
 
 namespace utils {
@@ -38,6 +40,8 @@ static std::string get_schedule_event_type_str(ScheduleEventType type) {
             return "freehost";
         case ScheduleEventType::free:
             return "free";
+        case ScheduleEventType::recompute:
+            return "recompute";
         default:
             break;
     }
@@ -54,10 +58,14 @@ struct ScheduleEvent final {
 
     ScheduleEventType type  = ScheduleEventType::allocate;
     std::string postop = "";    // For execution-triggered events, the event should be executed after executing postop.
-    long timepoint = 0;          // For timepoing-triggered events, the event should be executed after specificied timepoint.
+    long timepoint = 0;          // For timepoing-triggered events, the event should be executed after specificied timepoint, in microseconds.
 
     bool instant = false;
 
+    // Handles of the tensor and the operator, resolved by the frontend when the schedule is received.
+    TensorId   tensor_id   = invalid_id;
+    OperatorId operator_id = invalid_id;
+
     ScheduleEvent() = default;
     ScheduleEvent(const std::string& _op_name, const std::string& _tensor_name, size_t _size): operator_name(_op_name), tensor_name(_tensor_name), size(_size) {}
     ScheduleEvent(const std::string& _op_name, const std::string& _tensor_name, size_t _size, ScheduleEventType _event_type, const std::string& _postop, bool _instant = false): operator_name(_op_name), tensor_name(_tensor_name), size(_size), type(_event_type), postop(_postop), instant(_instant) {}
@@ -73,6 +81,13 @@ struct ScheduleEvents {
     layout::MemoryMap memory_map;
     StageScheduleEvents forward_schedule_events;
     StageScheduleEvents backward_schedule_events;
+
+    // Prediction of the schedule, reported by the planning schedulers.
+    size_t predicted_peak_memory = 0;
+    long   predicted_stall       = 0;   // microseconds
+
+    // Slack of prefetching per tensor measured in the last iteration, reported by the feedback schedulers. Negative slack is the stall, in microseconds.
+    std::unordered_map<std::string, long> slacks;
 };  // struct ScheduleEvents
 
 }   // namespace events
@@ -4,13 +4,21 @@
 #include <vector>
 #include <deque>
 #include <map>
+#include <array>
 #include <unordered_set>
 #include <unordered_map>
+#include <memory>
 #include <algorithm>
+#include <mutex>
+#include <atomic>
 #include <shared_mutex>
+#include <functional>
 #include <cassert>
 
+#include "includes/symbols.hpp"
+#include "includes/utils.hpp"
 #include "includes/memory_info.hpp"
+#include "includes/memory_layout.hpp"
 #include "includes/exceptions/status_exceptions.hpp"
 #include "includes/exceptions/memory_status_exceptions.hpp"
 
@@ -25,7 +33,10 @@ enum struct MemoryStatusType {
     none, empty, device, host, coexist, swapin, swapout
 };  // enum struct MemoryDataStatusType
 
+static constexpr size_t memory_status_type_count = 7;
+
 struct Tensor;
+struct MemorySections;
 
 /**
  * Describe memory data section on the specific computing acclerating device. 
@@ -34,10 +45,12 @@ struct Tensor;
 struct MemorySection final {
 private:
     friend struct Tensor;
+    friend struct MemorySections;
 
 private:
-    MemorySection* prev_sect = nullptr;
-    MemorySection* post_sect = nullptr;
+    // Sections of a tensor are stored contiguously, hence the neighbours are located by position.
+    bool first = true;
+    bool last  = true;
 
 public:
     size_t offset = 0;
@@ -56,17 +69,115 @@ public:
     MemorySection& operator=(const MemorySection&) = default;
     MemorySection& operator=(MemorySection&&) = default;
 
-    inline bool hasPrev() const { return prev_sect != nullptr; }
-    inline MemorySection* prev() { return prev_sect; }
-    inline const MemorySection* prev() const { return prev_sect; }
+    inline bool hasPrev() const { return !first; }
+    inline MemorySection* prev() { return first ? nullptr : this - 1; }
+    inline const MemorySection* prev() const { return first ? nullptr : this - 1; }
 
-    inline bool hasPost() const { return post_sect != nullptr; }
-    inline MemorySection* next() { return post_sect; }
-    inline const MemorySection* next() const { return post_sect; }
+    inline bool hasPost() const { return !last; }
+    inline MemorySection* next() { return last ? nullptr : this + 1; }
+    inline const MemorySection* next() const { return last ? nullptr : this + 1; }
 
     ~MemorySection() = default;
 };
 
+/**
+ * MemorySections
+ * Contiguous storage of the sections of a tensor, ordered by offset.
+ * Most tensors consist of no more than 4 sections, which are stored inline without heap allocation.
+ * Inserting or erasing sections invalidates the pointers to the following sections.
+ */
+struct MemorySections final {
+public:
+    static constexpr size_t inline_capacity = 4;
+
+private:
+    MemorySection inline_sections[inline_capacity];
+    std::vector<MemorySection> spilled_sections;
+    size_t count = 0;
+    bool   spilled = false;
+
+    void relink() {
+        MemorySection* p = data();
+        for (size_t i = 0; i < count; ++i) {
+            p[i].first = (i == 0);
+            p[i].last  = (i + 1 == count);
+        }
+    }
+
+public:
+    MemorySections() = default;
+    MemorySections(const MemorySections&) = default;
+    MemorySections(MemorySections&&) = default;
+    MemorySections& operator=(const MemorySections&) = default;
+    MemorySections& operator=(MemorySections&&) = default;
+
+    inline MemorySection* data() noexcept { return spilled ? spilled_sections.data() : inline_sections; }
+    inline const MemorySection* data() const noexcept { return spilled ? spilled_sections.data() : inline_sections; }
+
+    inline size_t size() const noexcept { return count; }
+    inline bool empty() const noexcept { return count == 0; }
+
+    inline MemorySection* begin() noexcept { return data(); }
+    inline MemorySection* end() noexcept { return data() + count; }
+    inline const MemorySection* begin() const noexcept { return data(); }
+    inline const MemorySection* end() const noexcept { return data() + count; }
+
+    inline MemorySection& front() { return data()[0]; }
+    inline MemorySection& back() { return data()[count - 1]; }
+    inline const MemorySection& front() const { return data()[0]; }
+    inline const MemorySection& back() const { return data()[count - 1]; }
+
+    inline MemorySection& operator[](size_t index) { return data()[index]; }
+    inline const MemorySection& operator[](size_t index) const { return data()[index]; }
+
+    /**
+     * Position of the section with the specific offset, or size() if not exists.
+     */
+    size_t find(size_t offset) const noexcept {
+        const MemorySection* p = std::lower_bound(begin(), end(), offset, [](const MemorySection& section, size_t offset) { return section.offset < offset; });
+        if (p == end() || p->offset != offset) return count;
+        return p - begin();
+    }
+
+    /**
+     * Insert a section at the specific position.
+     * @return reference to the inserted section
+     */
+    MemorySection& insert(size_t index, const MemorySection& section) {
+        assert(index <= count);
+        if (!spilled && count == inline_capacity) {
+            spilled_sections.assign(std::make_move_iterator(inline_sections), std::make_move_iterator(inline_sections + count));
+            spilled = true;
+        }
+        if (spilled) spilled_sections.insert(spilled_sections.begin() + index, section);
+        else {
+            std::move_backward(inline_sections + index, inline_sections + count, inline_sections + count + 1);
+            inline_sections[index] = section;
+        }
+        ++count;
+        relink();
+        return data()[index];
+    }
+
+    inline MemorySection& push_back(const MemorySection& section) { return insert(count, section); }
+
+    void erase(size_t index) {
+        assert(index < count);
+        if (spilled) spilled_sections.erase(spilled_sections.begin() + index);
+        else std::move(inline_sections + index + 1, inline_sections + count, inline_sections + index);
+        --count;
+        relink();
+    }
+
+    void clear() noexcept {
+        spilled_sections.clear();
+        spilled = false;
+        count = 0;
+    }
+
+    ~MemorySections() = default;
+};  // struct MemorySections
+
 /**
  * Fragment is a simplified MemorySection
  */
@@ -93,13 +204,18 @@ private:
 
 private:
     std::string name = "";
+    // Handle assigned by MemoryStatus at registration.
+    TensorId id = invalid_id;
 
-    // Tensor memory region consists of a series of data sections.
-    // Key is the offset of the section, value is the corresponding memory status.
+    // Tensor memory region consists of a series of data sections, ordered by offset.
     // When the tensor is fulfilly on device, the sections should be continuous.
-    std::map<size_t, MemorySection> sections;
+    MemorySections sections;
     Fragment fragment;
 
+    // Section count and bytes of each memory status, maintained incrementally.
+    std::array<size_t, memory_status_type_count> status_sections{};
+    std::array<size_t, memory_status_type_count> status_bytes{};
+
     // Tensor size
     size_t size = 0;
     // Remaining tensor size in memory
@@ -111,17 +227,62 @@ private:
     bool persistent = false;
     bool transient = false;
 
+    // Device owning the tensor. The data may be parked on a peer device under memory pressure.
+    DeviceId device = 0;
+
+    // Data dropped from device without a copy on host, to be recomputed when accessed.
+    bool dropped = false;
+
     std::string op = "";
+    OperatorId  op_id = invalid_id;
+
+    inline size_t statusIndex(MemoryStatusType status) const noexcept { return static_cast<size_t>(status); }
+
+    inline size_t countSections(MemoryStatusType status) const noexcept { return status_sections[statusIndex(status)]; }
+
+    void addSectionStatus(const MemorySection& section) noexcept {
+        ++status_sections[statusIndex(section.status)];
+        status_bytes[statusIndex(section.status)] += section.size;
+    }
+
+    void removeSectionStatus(const MemorySection& section) noexcept {
+        --status_sections[statusIndex(section.status)];
+        status_bytes[statusIndex(section.status)] -= section.size;
+    }
+
+    void setSectionStatus(MemorySection& section, MemoryStatusType status) noexcept {
+        removeSectionStatus(section);
+        section.status = status;
+        addSectionStatus(section);
+    }
+
+    void setSectionSize(MemorySection& section, size_t _size) noexcept {
+        removeSectionStatus(section);
+        section.size = _size;
+        addSectionStatus(section);
+    }
+
+    MemorySection& locateSection(size_t offset) {
+        size_t index = sections.find(offset);
+        if (index == sections.size()) throw memory_section_nonexist("Section not exists.");
+        return sections[index];
+    }
+
+    const MemorySection& locateSection(size_t offset) const {
+        size_t index = sections.find(offset);
+        if (index == sections.size()) throw memory_section_nonexist("Section not exists.");
+        return sections[index];
+    }
 
 public:
     Tensor() {
-        sections.emplace(0, MemorySection());
+        addSectionStatus(sections.push_back(MemorySection()));
     }
     Tensor(const std::string& _name): Tensor() {
         name = _name;
     }
     Tensor(const std::string& _name, size_t _size): name(_name), size(_size), device_size(_size), host_size(0) {
-        sections.emplace(0, MemorySection{0, _size, nullptr, nullptr, MemoryStatusType::none});
+        addSectionStatus(sections.push_back(MemorySection{0, _size, nullptr, nullptr, MemoryStatusType::none}));
         // if (_size < 1048576 * 4) transient = true; 
     }
     Tensor(const std::string& _name, size_t _size, MemoryDataType _type): Tensor(_name, _size) {
@@ -137,86 +298,106 @@ public:
 
     inline void setName(const std::string& _name) { name = _name; }
     inline void setType(MemoryDataType _type) { type = _type; }
-    inline void setSize(size_t _size) { size = _size; sections[0].size = _size; }
+    inline void setSize(size_t _size) { size = _size; setSectionSize(sections.front(), _size); }
     inline void setPersistent(bool _persistent) { persistent = _persistent; }
     inline void setTransient(bool _transient) { transient = _transient; }
+    inline void setDevice(DeviceId _device) { device = _device; }
+    inline void setDropped(bool _dropped) { dropped = _dropped; }
 
     inline std::string      getName()          const noexcept { return name; }
+    inline TensorId         getId()            const noexcept { return id; }
     inline std::string      getOperatorName()  const noexcept { return op; }
+    inline OperatorId       getOperatorId()    const noexcept { return op_id; }
     inline size_t           getSize()          const noexcept { return size; }
     inline size_t           getDeviceSize()    const noexcept { return device_size; }
     inline size_t           getHostSize()      const noexcept { return host_size; }
     inline MemoryDataType   getType()          const noexcept { return type; }
     inline bool             isPersistent()     const noexcept { return persistent; }
     inline bool             isTransient()      const noexcept { return transient; }
+    inline DeviceId         getDevice()        const noexcept { return device; }
+    inline bool             isDropped()        const noexcept { return dropped; }
 
-    inline const MemorySection& getSection(size_t offset) const { return sections.at(offset); }
+    inline const MemorySection& getSection(size_t offset) const { return locateSection(offset); }
     inline int getSectionCount() const noexcept { return sections.size(); }
-    inline const MemorySection& getFirstSection() const { return sections.begin()->second; }
-    inline const MemorySection& getLastSection() const { return sections.rbegin()->second; }
+    inline const MemorySection& getFirstSection() const { return sections.front(); }
+    inline const MemorySection& getLastSection() const { return sections.back(); }
+    inline const MemorySections& getSectionsView() const noexcept { return sections; }
     
     std::vector<size_t> getSections() const {
         std::vector<size_t> re;
-        for (auto &x : sections) re.push_back(x.first);
+        re.reserve(sections.size());
+        for (auto &x : sections) re.push_back(x.offset);
         return re;
     }
 
-    inline bool isSectionExist(size_t offset) const noexcept { return sections.find(offset) != sections.end(); }
+    inline bool isSectionExist(size_t offset) const noexcept { return sections.find(offset) != sections.size(); }
+
+    /**
+     * Total size of the sections in the specific memory status.
+     */
+    inline size_t getStatusSize(MemoryStatusType status) const noexcept { return status_bytes[statusIndex(status)]; }
+
+    /**
+     * Size of the data located on device or host, in contrast to getDeviceSize and getHostSize which count the data to be located.
+     */
+    inline size_t getDeviceResidentSize() const noexcept {
+        return getStatusSize(MemoryStatusType::empty) + getStatusSize(MemoryStatusType::device) + getStatusSize(MemoryStatusType::coexist);
+    }
+    inline size_t getHostResidentSize() const noexcept {
+        return getStatusSize(MemoryStatusType::host) + getStatusSize(MemoryStatusType::coexist);
+    }
+
+    inline layout::MemoryBlockType getBlockType() const noexcept {
+        if (persistent) return layout::MemoryBlockType::persistent;
+        if (transient) return layout::MemoryBlockType::transient;
+        return layout::MemoryBlockType::common;
+    }
 
     /**
      * If tensor has data located on device.
      */
     bool isDeviceLocated() const noexcept {
-        for (auto &x : sections) {
-            if (x.second.status == MemoryStatusType::empty || x.second.status == MemoryStatusType::device || x.second.status == MemoryStatusType::coexist) return true;
-        }
-        return false;
+        return countSections(MemoryStatusType::empty) + countSections(MemoryStatusType::device) + countSections(MemoryStatusType::coexist) != 0;
     }
     /**
      * If tensor has all data located on device.
      */
     bool isDeviceAllLocated() const noexcept {
-        for (auto &x : sections) {
-            if (x.second.status == MemoryStatusType::none || x.second.status == MemoryStatusType::host) return false;
-        }
-        return true;
+        return countSections(MemoryStatusType::none) + countSections(MemoryStatusType::host) == 0;
     }
     /**
      * If tensor has data located on host.
      */
     bool isHostLocated() const noexcept {
-        for (auto &x : sections) {
-            if (x.second.status == MemoryStatusType::host || x.second.status == MemoryStatusType::coexist) return true;
-        }
-        return false;
+        return countSections(MemoryStatusType::host) + countSections(MemoryStatusType::coexist) != 0;
     }
     /**
      * If tensor has all data located on host.
      */
     bool isHostAllLocated() const noexcept {
-        for (auto &x : sections) {
-            if (x.second.status == MemoryStatusType::none || x.second.status == MemoryStatusType::empty || x.second.status == MemoryStatusType::device) return false;
-        }
-        return true;
+        return countSections(MemoryStatusType::none) + countSections(MemoryStatusType::empty) + countSections(MemoryStatusType::device) == 0;
     }
     /**
      * If tensor has data located on host or device.
      */
     bool isMemoryLocated() const noexcept {
-        for (auto &x : sections) {
-            if (x.second.status != MemoryStatusType::none) return true;
-        }
-        return false;
+        return countSections(MemoryStatusType::none) != sections.size();
     }
 
-    void split(size_t offset, size_t size) {
+    /**
+     * Split the section at offset into two sections.
+     * Splitting may relocate the sections, hence the reference to the (front) section is returned.
+     */
+    MemorySection& split(size_t offset, size_t size) {
         assert(size != 0);
-        MemorySection& memory_section = sections.at(offset);
+        size_t index = sections.find(offset);
+        if (index == sections.size()) throw memory_section_nonexist("Section not exists.");
+        MemorySection& memory_section = sections[index];
 
         if (memory_section.size < size) {
             throw memory_section_invalid("Sectioning size larger than section size.");
         }
-        if (memory_section.size == size) return;
+        if (memory_section.size == size) return memory_section;
 
         MemorySection new_section;
         new_section.offset         = memory_section.offset + size;
@@ -224,70 +405,65 @@ public:
         if (memory_section.host_address   != nullptr) new_section.host_address   = (uint8_t*)memory_section.host_address   + size;
         if (memory_section.device_address != nullptr) new_section.device_address = (uint8_t*)memory_section.device_address + size;
         new_section.status         = memory_section.status;
-        new_section.prev_sect      = &memory_section;
-        new_section.post_sect      = memory_section.post_sect;
 
+        // Bytes of the status are unchanged, only the section count increases.
         memory_section.size        = size;
+        ++status_sections[statusIndex(new_section.status)];
 
-        sections.emplace(offset + size, new_section);
-        memory_section.post_sect = &(sections.at(offset + size));
+        sections.insert(index + 1, new_section);
+        return sections[index];
     }
 
     inline bool isMergeable(size_t offset) {
-        auto pb = sections.find(offset);
-        if (pb == sections.end()) throw memory_section_invalid("Invalid section offset.");
-        MemorySection& memory_section = pb->second;
-        auto pe = ++pb;
+        size_t index = sections.find(offset);
+        if (index == sections.size()) throw memory_section_invalid("Invalid section offset.");
+        MemorySection& memory_section = sections[index];
 
-        if (pe == sections.end()) return false;
-        if (pe->second.status != memory_section.status) return false;
+        if (!memory_section.hasPost()) return false;
+        MemorySection& post_section = *memory_section.next();
+        if (post_section.status != memory_section.status) return false;
         if (memory_section.status == MemoryStatusType::host || memory_section.status == MemoryStatusType::coexist) return false;
 
-        assert((uint8_t*)memory_section.device_address + memory_section.size == pe->second.device_address);
+        assert((uint8_t*)memory_section.device_address + memory_section.size == post_section.device_address);
         return true;
     }
 
     MemorySection& merge(size_t offset = 0) {
         if (!isMergeable(offset)) throw memory_section_invalid("Invalid section merging.");
 
-        MemorySection& memory_section = sections.at(offset);
-        MemorySection& post_section = *memory_section.post_sect;
-        size_t post_offset = post_section.offset;
-
-        memory_section.size += post_section.size;
-        memory_section.post_sect = post_section.post_sect;
-        if (memory_section.post_sect != nullptr) memory_section.post_sect->prev_sect = &memory_section;
-        sections.erase(post_offset);
+        size_t index = sections.find(offset);
+        MemorySection& memory_section = sections[index];
+        memory_section.size += sections[index + 1].size;
+        --status_sections[statusIndex(memory_section.status)];
+        sections.erase(index + 1);
 
-        return memory_section;
+        return sections[index];
     }
 
     void setReshaped(size_t _size) {
         // Since the allocation takes place in the beginning of the application procedure, there should be only one memory section.
         if (sections.size() != 1) throw status_exception("Set reshaped for sectioned tensor.");
-        assert(sections.begin()->first == 0);
-        assert(sections.begin()->second.offset == 0);
+        assert(sections.front().offset == 0);
         size = _size;
-        sections.begin()->second.size = size;
-        if (sections[0].status != MemoryStatusType::none) throw status_exception("Set reshaped for allocated tensor.");
+        setSectionSize(sections.front(), size);
+        if (sections.front().status != MemoryStatusType::none) throw status_exception("Set reshaped for allocated tensor.");
         device_size = size;
     }
     void setAllocated(void* device_address) {
         // Since the allocation takes place in the beginning of the application procedure, there should be only one memory section.
         if (sections.size() != 1) throw status_exception("Set allocated for sectioned tensor.");
-        assert(sections.begin()->first == 0);
-        assert(sections.begin()->second.offset == 0);
-        assert(sections.begin()->second.size == size);
-        if (sections[0].status != MemoryStatusType::none) throw status_exception("Set allocated for allocated tensor.");
-        sections[0].device_address = device_address;
-        sections[0].status = MemoryStatusType::empty;
+        assert(sections.front().offset == 0);
+        assert(sections.front().size == size);
+        if (sections.front().status != MemoryStatusType::none) throw status_exception("Set allocated for allocated tensor.");
+        sections.front().device_address = device_address;
+        setSectionStatus(sections.front(), MemoryStatusType::empty);
         device_size = size;
     }
     void setAssigned() {
         for (auto &x : sections) {
-            switch(x.second.status) {
+            switch(x.status) {
                 case MemoryStatusType::empty:
-                    if (size != 0) x.second.status = MemoryStatusType::device;
+                    if (size != 0) setSectionStatus(x, MemoryStatusType::device);
                 case MemoryStatusType::device:
                     break;
                 case MemoryStatusType::coexist:
@@ -299,7 +475,7 @@ public:
     }
     void setAcquired() {
         for (auto &x : sections) {
-            switch(x.second.status) {
+            switch(x.status) {
                 case MemoryStatusType::coexist:
                 case MemoryStatusType::device:
                 case MemoryStatusType::empty:
@@ -313,11 +489,11 @@ public:
         setAssigned();
     }
     void setCopiedOut(size_t offset, void* host_address) {
-        MemorySection& memory_section = sections.at(offset);
+        MemorySection& memory_section = locateSection(offset);
         memory_section.host_address = host_address;
         switch(memory_section.status) {
             case MemoryStatusType::device:
-                memory_section.status = MemoryStatusType::coexist;
+                setSectionStatus(memory_section, MemoryStatusType::coexist);
                 host_size += memory_section.size;
             case MemoryStatusType::coexist:
             case MemoryStatusType::empty:
@@ -329,20 +505,19 @@ public:
     }
     void setCopiedOut(void* host_address) {
         if (sections.size() != 1) throw status_exception("Set copied out for sectioned tensor.");
-        assert(sections.begin()->first == 0);
-        assert(sections.begin()->second.offset == 0);
-        assert(sections.begin()->second.size == size);
+        assert(sections.front().offset == 0);
+        assert(sections.front().size == size);
         setCopiedOut(0, host_address);
     }
     void setCopiedIn(size_t offset, void* device_address) {
-        MemorySection& memory_section = sections.at(offset);
+        MemorySection& memory_section = locateSection(offset);
         memory_section.device_address = device_address;
         switch(memory_section.status) {
             case MemoryStatusType::none:
-                memory_section.status = MemoryStatusType::empty;
+                setSectionStatus(memory_section, MemoryStatusType::empty);
                 break;
             case MemoryStatusType::host:
-                memory_section.status = MemoryStatusType::coexist;
+                setSectionStatus(memory_section, MemoryStatusType::coexist);
             case MemoryStatusType::coexist:
                 break;
             default:    // device empty
@@ -353,13 +528,12 @@ public:
     }
     void setCopiedIn(void* device_address) {
         if (sections.size() != 1) throw status_exception("Set copied in for sectioned tensor.");
-        assert(sections.begin()->first == 0);
-        assert(sections.begin()->second.offset == 0);
-        assert(sections.begin()->second.size == size);
+        assert(sections.front().offset == 0);
+        assert(sections.front().size == size);
         setCopiedIn(0, device_address);
     }
     void setMoved(size_t offset, void* dst_address) {
-        MemorySection& memory_section = sections.at(offset);
+        MemorySection& memory_section = locateSection(offset);
         memory_section.device_address = dst_address;
         switch(memory_section.status) {
             case MemoryStatusType::empty:
@@ -372,13 +546,13 @@ public:
         }
     }
     void setHostFreed(size_t offset) {
-        MemorySection& memory_section = sections.at(offset);
+        MemorySection& memory_section = locateSection(offset);
         switch (memory_section.status) {
             case MemoryStatusType::coexist:
-                memory_section.status = MemoryStatusType::device;
+                setSectionStatus(memory_section, MemoryStatusType::device);
                 break;
             case MemoryStatusType::host:
-                memory_section.status = MemoryStatusType::none;
+                setSectionStatus(memory_section, MemoryStatusType::none);
                 break;
             default:    // none empty device
                 throw status_exception("No data on host while freeing host memory.");
@@ -387,14 +561,14 @@ public:
         
     }
     void setDeviceFreed(size_t offset) {
-        MemorySection& memory_section = sections.at(offset);
+        MemorySection& memory_section = locateSection(offset);
         switch (memory_section.status) {
             case MemoryStatusType::coexist:
-                memory_section.status = MemoryStatusType::host;
+                setSectionStatus(memory_section, MemoryStatusType::host);
                 break;
             case MemoryStatusType::empty:
             case MemoryStatusType::device:
-                memory_section.status = MemoryStatusType::none;
+                setSectionStatus(memory_section, MemoryStatusType::none);
                 break;
             default:    // none host
                 throw status_exception("No data on host while freeing host memory.");
@@ -403,7 +577,7 @@ public:
         device_size -= memory_section.size;
     }
     void setFreed(size_t offset) {
-        MemorySection& memory_section = sections.at(offset);
+        MemorySection& memory_section = locateSection(offset);
         switch (memory_section.status) {
             case MemoryStatusType::coexist:
                 device_size -= memory_section.size;
@@ -419,7 +593,7 @@ public:
             default:    // none
                 throw status_exception("No data on host and device while freeing memory.");
         }
-        memory_section.status = MemoryStatusType::none;
+        setSectionStatus(memory_section, MemoryStatusType::none);
     }
 
     inline bool hasFragment() const noexcept { return fragment.size != 0; }
@@ -435,7 +609,7 @@ public:
         fragment.address = address;
     }
 
-    inline void setFragmentPlaced() { setFragmentPlaced((uint8_t*)(sections.at(0).device_address) + size); }
+    inline void setFragmentPlaced() { setFragmentPlaced((uint8_t*)(sections.front().device_address) + size); }
 
     void setFragmentRemoved() {
         if (fragment.status == MemoryStatusType::none) throw status_exception("Removing non-exist fragment.");
@@ -455,15 +629,20 @@ struct OperatorPres;
 struct Operator final {
 private:
     friend struct OperatorPres;
+    friend struct MemoryStatus;
 
 private:
     // Operator name.
     std::string name = "";
+    // Handle assigned by MemoryStatus at registration.
+    OperatorId id = invalid_id;
     // Prev and post dependencies.
     std::unordered_set<std::string> prevs, posts;  
 
     // Tensors consisting of this operator.
     std::unordered_set<std::string> tensors;
+    // Handles of the tensors, resolved at registration.
+    std::vector<TensorId> tensor_ids;
 
     // std::shared_mutex m;
 
@@ -491,8 +670,8 @@ public:
     inline bool isPrev(const std::string& op) const { return prevs.find(op) != prevs.end(); }
     inline bool isPost(const std::string& op) const { return posts.find(op) != posts.end(); }
 
-    inline std::unordered_set<std::string> getPrevs() const noexcept { return prevs; }
-    inline std::unordered_set<std::string> getPosts() const noexcept { return posts; }
+    inline const std::unordered_set<std::string>& getPrevs() const noexcept { return prevs; }
+    inline const std::unordered_set<std::string>& getPosts() const noexcept { return posts; }
 
     void removePrev(const std::string& op) {
         auto p = prevs.find(op);
@@ -516,7 +695,8 @@ public:
     }
 
     bool  isTensorIncluded(const std::string& tensor) const { return tensors.find(tensor) != tensors.end(); }
-    const std::unordered_set<std::string> getTensors() const noexcept { return tensors; }
+    inline const std::unordered_set<std::string>& getTensors() const noexcept { return tensors; }
+    inline const std::vector<TensorId>& getTensorIds() const noexcept { return tensor_ids; }
 
     void removeTensor(const std::string& tensor) {
         auto p = tensors.find(tensor);
@@ -528,6 +708,7 @@ public:
 
     inline void        setName(const std::string& _name) noexcept { name = _name; }
     inline std::string getName() const noexcept { return name; }
+    inline OperatorId  getId()   const noexcept { return id; }
 
     ~Operator() = default;
 
@@ -535,6 +716,91 @@ public:
 
 struct MemoryStatus;
 
+/**
+ * MemoryAccounting
+ * Byte totals of the registered tensors, by memory block type.
+ * Maintained incrementally by the memory status transitions of TensorPres, hence readable without scanning the tensors.
+ */
+struct MemoryAccounting final {
+private:
+    friend struct TensorPres;
+    friend struct MemoryStatus;
+
+    static constexpr size_t block_type_count = 3;
+
+private:
+    std::array<std::atomic<size_t>, block_type_count> device_sizes{};
+    std::array<std::atomic<size_t>, block_type_count> host_sizes{};
+    std::atomic<size_t> transferring_size{0};
+    // Tensors being transferred, with the count of the transferring in flight.
+    std::unordered_map<TensorId, int> transferring_tensors;
+    mutable std::mutex transferring_m;
+
+    static inline size_t blockIndex(layout::MemoryBlockType block) noexcept { return static_cast<size_t>(block); }
+
+    void update(layout::MemoryBlockType block, size_t device_b, size_t device_e, size_t host_b, size_t host_e) noexcept {
+        // Unsigned wrap-around keeps the deltas correct for releasing.
+        if (device_b != device_e) device_sizes[blockIndex(block)].fetch_add(device_e - device_b);
+        if (host_b != host_e) host_sizes[blockIndex(block)].fetch_add(host_e - host_b);
+    }
+
+    void assign(const MemoryAccounting& accounting) noexcept {
+        for (size_t i = 0; i < block_type_count; ++i) {
+            device_sizes[i] = accounting.device_sizes[i].load();
+            host_sizes[i] = accounting.host_sizes[i].load();
+        }
+        transferring_size = accounting.transferring_size.load();
+    }
+
+    void setTransferring(TensorId tensor, bool transferring) {
+        std::unique_lock<std::mutex> l{transferring_m};
+        if (transferring) ++transferring_tensors[tensor];
+        else if (--transferring_tensors[tensor] == 0) transferring_tensors.erase(tensor);
+    }
+
+public:
+    /**
+     * Transferring
+     * Account the data of the tensor being transferred between device and host during the lifetime.
+     */
+    struct Transferring final {
+    private:
+        MemoryAccounting& accounting;
+        TensorId tensor;
+        size_t size;
+
+    public:
+        Transferring(MemoryAccounting& _accounting, TensorId _tensor, size_t _size): accounting(_accounting), tensor(_tensor), size(_size) {
+            accounting.transferring_size += size;
+            if (size != 0) accounting.setTransferring(tensor, true);
+        }
+        Transferring(const Transferring&) = delete;
+        ~Transferring() {
+            if (size != 0) accounting.setTransferring(tensor, false);
+            accounting.transferring_size -= size;
+        }
+    };  // inner struct Transferring
+
+public:
+    MemoryAccounting() = default;
+    MemoryAccounting(const MemoryAccounting& accounting) { assign(accounting); }
+    MemoryAccounting& operator=(const MemoryAccounting& accounting) { assign(accounting); return *this; }
+
+    inline size_t getDeviceSize(layout::MemoryBlockType block) const noexcept { return device_sizes[blockIndex(block)]; }
+    inline size_t getHostSize(layout::MemoryBlockType block) const noexcept { return host_sizes[blockIndex(block)]; }
+    inline size_t getDeviceSize() const noexcept { return device_sizes[0] + device_sizes[1] + device_sizes[2]; }
+    inline size_t getHostSize() const noexcept { return host_sizes[0] + host_sizes[1] + host_sizes[2]; }
+    inline size_t getTransferringSize() const noexcept { return transferring_size; }
+    bool isTransferring(TensorId tensor) const {
+        std::unique_lock<std::mutex> l{transferring_m};
+        return transferring_tensors.count(tensor) != 0;
+    }
+    /**
+     * Device data that can be swapped out, i.e. the data of the tensors in the common block.
+     */
+    inline size_t getSwappableSize() const noexcept { return getDeviceSize(layout::MemoryBlockType::common); }
+};  // struct MemoryAccounting
+
 struct TensorPres final {
 private:
     friend struct MemoryStatus;
@@ -545,13 +811,28 @@ public:
 private:
     Tensor& status;
     std::unique_lock<std::shared_mutex> l;
+    // Keep the status alive if it is unregistered or detached.
+    std::shared_ptr<const void> owner;
+    MemoryAccounting& accounting;
 
-    TensorPres(Tensor& _status, std::shared_mutex& m): status(_status) {
+    TensorPres(Tensor& _status, std::shared_mutex& m, std::shared_ptr<const void> _owner, MemoryAccounting& _accounting): status(_status), owner(std::move(_owner)), accounting(_accounting) {
         l = std::unique_lock<std::shared_mutex>{m, std::try_to_lock};
     }
+    TensorPres(Tensor& _status, std::shared_mutex& m, std::defer_lock_t, std::shared_ptr<const void> _owner, MemoryAccounting& _accounting): status(_status), l(m, std::defer_lock), owner(std::move(_owner)), accounting(_accounting) {}
+
+    /**
+     * Perform a memory status transition, and account the changes of the resident data.
+     */
+    template <typename F>
+    inline void transit(F&& func) {
+        size_t device_b = status.getDeviceResidentSize();
+        size_t host_b   = status.getHostResidentSize();
+        func();
+        accounting.update(status.getBlockType(), device_b, status.getDeviceResidentSize(), host_b, status.getHostResidentSize());
+    }
 
 public:
-    TensorPres(TensorPres&& _pres): status(_pres.status) {
+    TensorPres(TensorPres&& _pres): status(_pres.status), owner(std::move(_pres.owner)), accounting(_pres.accounting) {
         l = std::move(_pres.l);
     }
 
@@ -559,37 +840,45 @@ public:
     inline void reference() { l.lock(); }
 
 public:
-    inline void setReshaped(size_t size) { status.setReshaped(size); }
-    inline void setAllocated(void* device_address) { status.setAllocated(device_address); }
+    inline void setReshaped(size_t size) { transit([&]() { status.setReshaped(size); }); }
+    inline void setAllocated(void* device_address) { transit([&]() { status.setAllocated(device_address); }); }
 
     inline void setAssigned() { status.setAssigned(); }
     inline void setAcquired() { status.setAcquired(); }
     inline void setAccessed() { status.setAccessed(); }
 
-    inline void setCopiedOut(size_t offset, void* host_address) { status.setCopiedOut(offset, host_address); }
-    inline void setCopiedOut(void* host_address) { status.setCopiedOut(host_address); }
-    inline void setCopiedIn(size_t offset, void* device_address) { status.setCopiedIn(offset, device_address); }
-    inline void setCopiedIn(void* device_address) { status.setCopiedIn(device_address); }
+    inline void setCopiedOut(size_t offset, void* host_address) { transit([&]() { status.setCopiedOut(offset, host_address); }); }
+    inline void setCopiedOut(void* host_address) { transit([&]() { status.setCopiedOut(host_address); }); }
+    inline void setCopiedIn(size_t offset, void* device_address) { transit([&]() { status.setCopiedIn(offset, device_address); }); }
+    inline void setCopiedIn(void* device_address) { transit([&]() { status.setCopiedIn(device_address); }); }
     inline void setMoved(size_t offset, void* dst_address) { status.setMoved(offset, dst_address); }
-    inline void setHostFreed(size_t offset = 0)   { status.setHostFreed(offset); }
-    inline void setDeviceFreed(size_t offset = 0) { status.setDeviceFreed(offset); }
-    inline void setFreed(size_t offset = 0)       { status.setFreed(offset); }
+    inline void setDevice(DeviceId device) { status.setDevice(device); }
+    inline void setDropped(bool dropped) { status.setDropped(dropped); }
+    inline void setHostFreed(size_t offset = 0)   { transit([&]() { status.setHostFreed(offset); }); }
+    inline void setDeviceFreed(size_t offset = 0) { transit([&]() { status.setDeviceFreed(offset); }); }
+    inline void setFreed(size_t offset = 0)       { transit([&]() { status.setFreed(offset); }); }
 
     inline std::string      getName()           const noexcept { return status.getName(); }
+    inline TensorId         getId()             const noexcept { return status.getId(); }
     inline std::string      getOperatorName()   const noexcept { return status.getOperatorName(); }
+    inline OperatorId       getOperatorId()     const noexcept { return status.getOperatorId(); }
     inline size_t           getSize()           const noexcept { return status.getSize(); }
     inline size_t           getDeviceSize()     const noexcept { return status.getDeviceSize(); }
     inline size_t           getHostSize()       const noexcept { return status.getHostSize(); }
     inline MemoryDataType   getType()           const noexcept { return status.getType(); }
     inline bool             isPersistent()      const noexcept { return status.isPersistent(); }
     inline bool             isTransient()       const noexcept { return status.isTransient(); }
+    inline DeviceId         getDevice()         const noexcept { return status.getDevice(); }
+    inline bool             isDropped()         const noexcept { return status.isDropped(); }
 
     inline const MemorySection& getSection(size_t offset) const { return status.getSection(offset); }
     inline int getSectionCount() const noexcept { return status.getSectionCount(); }
     inline const MemorySection& getFirstSection() const { return status.getFirstSection(); }
     inline const MemorySection& getLastSection() const { return status.getLastSection(); }
+    inline const MemorySections& getSectionsView() const noexcept { return status.getSectionsView(); }
 
     inline bool isSectionExist(size_t offset) const noexcept { return status.isSectionExist(offset); }
+    inline size_t getStatusSize(MemoryStatusType _status) const noexcept { return status.getStatusSize(_status); }
 
     inline bool isDeviceLocated()    const noexcept { return status.isDeviceLocated(); }
     inline bool isDeviceAllLocated() const noexcept { return status.isDeviceAllLocated(); }
@@ -599,7 +888,7 @@ public:
 
     inline Tensor& get() noexcept { return status; }
 
-    inline void split(size_t offset, size_t size) { status.split(offset, size); }
+    inline MemorySection& split(size_t offset, size_t size) { return status.split(offset, size); }
     inline bool isMergeable(size_t offset) const { return status.isMergeable(offset); }
     inline MemorySection& merge(size_t offset = 0) { return status.merge(offset); }
 
@@ -627,13 +916,15 @@ private:
     Operator& status;
     // Operator is read-only during DL processing.
     std::unique_lock<std::shared_mutex> l;
+    std::shared_ptr<const void> owner;
 
-    OperatorPres(Operator& _status, std::shared_mutex& m): status(_status) {
+    OperatorPres(Operator& _status, std::shared_mutex& m, std::shared_ptr<const void> _owner): status(_status), owner(std::move(_owner)) {
         l = std::unique_lock<std::shared_mutex>(m, std::try_to_lock);
     }
+    OperatorPres(Operator& _status, std::shared_mutex& m, std::defer_lock_t, std::shared_ptr<const void> _owner): status(_status), l(m, std::defer_lock), owner(std::move(_owner)) {}
 
 public:
-    OperatorPres(OperatorPres&& _pres): status(_pres.status) {
+    OperatorPres(OperatorPres&& _pres): status(_pres.status), owner(std::move(_pres.owner)) {
         l = std::move(_pres.l);
     }
 
@@ -642,15 +933,146 @@ public:
 
 public:
     inline std::string                     getName()    const noexcept { return status.getName(); }
-    inline std::unordered_set<std::string> getPrevs()   const noexcept { return status.getPrevs(); }
-    inline std::unordered_set<std::string> getPosts()   const noexcept { return status.getPosts(); }
-    inline std::unordered_set<std::string> getTensors() const noexcept { return status.getTensors(); }
+    // The references are valid as long as the presentation holds the operator lock.
+    inline const std::unordered_set<std::string>& getPrevs()     const noexcept { return status.getPrevs(); }
+    inline const std::unordered_set<std::string>& getPosts()     const noexcept { return status.getPosts(); }
+    inline const std::unordered_set<std::string>& getTensors()   const noexcept { return status.getTensors(); }
+    inline OperatorId                             getId()        const noexcept { return status.getId(); }
+    inline const std::vector<TensorId>&           getTensorIds() const noexcept { return status.getTensorIds(); }
 
     inline bool isBackwardPropagation() const noexcept { return status.isBackwardPropagation(); }
 
     inline Operator& get() noexcept { return status; }
 };  // struct OperatorPres
 
+/**
+ * ConstTensorPres
+ * Read-only presentation of a tensor.
+ * Holds a shared lock, hence readers run concurrently and are only blocked by TensorPres.
+ */
+struct ConstTensorPres final {
+private:
+    friend struct MemoryStatus;
+
+public:
+    using target_type = const Tensor;
+
+private:
+    const Tensor& status;
+    std::shared_lock<std::shared_mutex> l;
+    // Keep the status alive if it is unregistered or detached.
+    std::shared_ptr<const void> owner;
+
+    ConstTensorPres(const Tensor& _status, std::shared_mutex& m, std::shared_ptr<const void> _owner): status(_status), owner(std::move(_owner)) {
+        l = std::shared_lock<std::shared_mutex>{m, std::try_to_lock};
+    }
+
+public:
+    ConstTensorPres(ConstTensorPres&& _pres): status(_pres.status), owner(std::move(_pres.owner)) {
+        l = std::move(_pres.l);
+    }
+
+    inline bool isReferenced() const noexcept { return l.owns_lock(); }
+    inline void reference() { l.lock(); }
+
+public:
+    inline std::string      getName()           const noexcept { return status.getName(); }
+    inline TensorId         getId()             const noexcept { return status.getId(); }
+    inline std::string      getOperatorName()   const noexcept { return status.getOperatorName(); }
+    inline OperatorId       getOperatorId()     const noexcept { return status.getOperatorId(); }
+    inline size_t           getSize()           const noexcept { return status.getSize(); }
+    inline size_t           getDeviceSize()     const noexcept { return status.getDeviceSize(); }
+    inline size_t           getHostSize()       const noexcept { return status.getHostSize(); }
+    inline MemoryDataType   getType()           const noexcept { return status.getType(); }
+    inline bool             isPersistent()      const noexcept { return status.isPersistent(); }
+    inline bool             isTransient()       const noexcept { return status.isTransient(); }
+    inline DeviceId         getDevice()         const noexcept { return status.getDevice(); }
+    inline bool             isDropped()         const noexcept { return status.isDropped(); }
+
+    inline const MemorySection& getSection(size_t offset) const { return status.getSection(offset); }
+    inline int getSectionCount() const noexcept { return status.getSectionCount(); }
+    inline const MemorySection& getFirstSection() const { return status.getFirstSection(); }
+    inline const MemorySection& getLastSection() const { return status.getLastSection(); }
+    inline const MemorySections& getSectionsView() const noexcept { return status.getSectionsView(); }
+
+    inline bool isSectionExist(size_t offset) const noexcept { return status.isSectionExist(offset); }
+    inline size_t getStatusSize(MemoryStatusType _status) const noexcept { return status.getStatusSize(_status); }
+
+    inline bool isDeviceLocated()    const noexcept { return status.isDeviceLocated(); }
+    inline bool isDeviceAllLocated() const noexcept { return status.isDeviceAllLocated(); }
+    inline bool isHostLocated()      const noexcept { return status.isHostLocated(); }
+    inline bool isHostAllLocated()   const noexcept { return status.isHostAllLocated(); }
+    inline bool isMemoryLocated()    const noexcept { return status.isMemoryLocated(); }
+
+    inline bool hasFragment() const noexcept { return status.hasFragment(); }
+    inline const Fragment& getFragment() const noexcept { return status.getFragment(); }
+
+    inline const Tensor& get() const noexcept { return status; }
+
+    inline void release() { l.unlock(); }
+
+    ~ConstTensorPres() { if (l.owns_lock()) release(); }
+};  // struct ConstTensorPres
+
+/**
+ * ConstOperatorPres
+ * Read-only presentation of an operator.
+ */
+struct ConstOperatorPres final {
+private:
+    friend struct MemoryStatus;
+
+public:
+    using target_type = const Operator;
+
+private:
+    const Operator& status;
+    std::shared_lock<std::shared_mutex> l;
+    std::shared_ptr<const void> owner;
+
+    ConstOperatorPres(const Operator& _status, std::shared_mutex& m, std::shared_ptr<const void> _owner): status(_status), owner(std::move(_owner)) {
+        l = std::shared_lock<std::shared_mutex>(m, std::try_to_lock);
+    }
+
+public:
+    ConstOperatorPres(ConstOperatorPres&& _pres): status(_pres.status), owner(std::move(_pres.owner)) {
+        l = std::move(_pres.l);
+    }
+
+    inline bool isReferenced() const noexcept { return l.owns_lock(); }
+    inline void reference() { l.lock(); }
+
+public:
+    inline std::string                            getName()      const noexcept { return status.getName(); }
+    // The references are valid as long as the presentation holds the operator lock.
+    inline const std::unordered_set<std::string>& getPrevs()     const noexcept { return status.getPrevs(); }
+    inline const std::unordered_set<std::string>& getPosts()     const noexcept { return status.getPosts(); }
+    inline const std::unordered_set<std::string>& getTensors()   const noexcept { return status.getTensors(); }
+    inline OperatorId                             getId()        const noexcept { return status.getId(); }
+    inline const std::vector<TensorId>&           getTensorIds() const noexcept { return status.getTensorIds(); }
+
+    inline bool isBackwardPropagation() const noexcept { return status.isBackwardPropagation(); }
+
+    inline const Operator& get() const noexcept { return status; }
+};  // struct ConstOperatorPres
+
+/**
+ * MemoryStatusDelta
+ * Registrations and unregistrations of a status, applied to its copies instead of copying the whole status.
+ * Unregistrations are applied first, then the tensor registrations and the operator registrations, each in the submitted order.
+ */
+struct MemoryStatusDelta final {
+    // Registered tensors and operators, with the handles assigned by the source status.
+    std::vector<Tensor>   registered_tensors;
+    std::vector<Operator> registered_operators;
+    std::vector<std::string> unregistered_tensors;
+    std::vector<std::string> unregistered_operators;
+
+    inline bool empty() const noexcept {
+        return registered_tensors.empty() && registered_operators.empty() && unregistered_tensors.empty() && unregistered_operators.empty();
+    }
+};  // struct MemoryStatusDelta
+
 /**
  * MemoryStatus
  * Storage of tensor status and corresponding operator status.
@@ -660,85 +1082,482 @@ private:
     template <typename T>
     struct View final {
         T pres;
+        // Wait for the target, if the presentation could not be prepared without blocking.
+        std::function<T()> wait;
         
-        View(typename T::target_type& _target, std::shared_mutex& m): pres(_target, m) {}
+        template <typename... Args>
+        View(typename T::target_type& _target, std::shared_mutex& m, Args&&... args): pres(_target, m, std::forward<Args>(args)...) {}
+        View(T&& _pres, std::function<T()> _wait): pres(std::move(_pres)), wait(std::move(_wait)) {}
 
         inline bool isReferenced() { return pres.isReferenced(); }
-        inline T&& reference() { 
-            if (!pres.isReferenced())
-                pres.reference();
+        inline T reference() { 
+            if (pres.isReferenced()) return std::move(pres);
+            if (wait) return wait();
+            pres.reference();
             return std::move(pres);
         }
     };  // inner struct View
 
+    /**
+     * Generation of the holds, identified by the address.
+     * Copying a status starts new generations for both the copies, hence the holds of former generations are shared.
+     */
+    struct Generation final {};
+
     template <typename T>
-    struct Hold {
+    struct Hold : public std::enable_shared_from_this<Hold<T>> {
         T target;
         std::shared_mutex m;
-        Hold(const T& _target): target(_target) {}
-        Hold(T&& _target): target(_target) {}
-        Hold(const Hold& _hold): target(_hold.target) {}
-        Hold(Hold&&) = default;
+        // Holds of former generations are detached before modified.
+        std::shared_ptr<const Generation> generation;
 
-        Hold& operator=(const Hold& _hold) { target = _hold.target; return *this; }
-        Hold& operator=(Hold&& _hold) = default;
+        Hold(const T& _target, std::shared_ptr<const Generation> _generation): target(_target), generation(std::move(_generation)) {}
     };  // inner struct Hold
 
+    /**
+     * Holds indexed by handle, which are read without locking.
+     * The slots are stored in segments of doubling sizes, hence growing never relocates the slots.
+     * The owners of the holds are only accessed by the writers, with tables_m locked.
+     * Replaced holds should be retired, since they may be still read by the lookups.
+     */
+    template <typename T>
+    struct Slots final {
+    private:
+        static constexpr size_t first_segment_size = 64;
+        static constexpr size_t segment_limit = 48;
+
+        std::array<std::atomic<std::atomic<Hold<T>*>*>, segment_limit> segments;
+        std::atomic<size_t> count{0};
+        std::vector<std::shared_ptr<Hold<T>>> owners;
+
+        static inline std::pair<size_t, size_t> locate(size_t index) noexcept {
+            size_t n = index / first_segment_size + 1;
+            size_t segment = 0;
+            while (n >> (segment + 1)) ++segment;
+            return std::make_pair(segment, index - first_segment_size * ((size_t(1) << segment) - 1));
+        }
+
+        std::atomic<Hold<T>*>& slot(size_t index) {
+            auto p = locate(index);
+            std::atomic<Hold<T>*>* segment = segments[p.first].load();
+            if (segment == nullptr) {
+                segment = new std::atomic<Hold<T>*>[first_segment_size << p.first];
+                segments[p.first].store(segment);
+            }
+            return segment[p.second];
+        }
+
+    public:
+        Slots() { for (auto &x : segments) x.store(nullptr); }
+        Slots(const Slots&) = delete;
+
+        inline size_t size() const noexcept { return count.load(); }
+
+        /**
+         * Read the hold without locking. Empty if out of range or unregistered.
+         */
+        Hold<T>* load(size_t index) const noexcept {
+            if (index >= count.load()) return nullptr;
+            auto p = locate(index);
+            return segments[p.first].load()[p.second].load();
+        }
+
+        inline const std::shared_ptr<Hold<T>>& get(size_t index) const { return owners[index]; }
+
+        /**
+         * Replace the hold.
+         * @return the replaced hold to be retired
+         */
+        std::shared_ptr<Hold<T>> set(size_t index, std::shared_ptr<Hold<T>> hold) {
+            slot(index).store(hold.get());
+            std::swap(owners[index], hold);
+            return hold;
+        }
+
+        void push_back(std::shared_ptr<Hold<T>> hold) {
+            size_t index = owners.size();
+            slot(index).store(hold.get());
+            owners.push_back(std::move(hold));
+            count.store(owners.size());
+        }
+
+        /**
+         * Replace all the holds.
+         * @return the replaced holds to be retired
+         */
+        std::vector<std::shared_ptr<Hold<T>>> assign(std::vector<std::shared_ptr<Hold<T>>> holds) {
+            count.store(std::min(count.load(), holds.size()));
+            for (size_t i = 0; i < holds.size(); ++i) slot(i).store(holds[i].get());
+            std::swap(owners, holds);
+            count.store(owners.size());
+            return holds;
+        }
+
+        inline const std::vector<std::shared_ptr<Hold<T>>>& getOwners() const noexcept { return owners; }
+
+        ~Slots() { for (auto &x : segments) delete[] x.load(); }
+    };  // inner struct Slots
+
+    /**
+     * Contiguous snapshots of the execution orders, built on the first reading.
+     * Shared between tables with the same execution order.
+     */
+    struct OrderSnapshots final {
+        std::atomic<const std::vector<std::string>*> execution_order{nullptr};
+        std::atomic<const std::vector<std::string>*> forward_execution_order{nullptr};
+        std::atomic<const std::vector<std::string>*> backward_execution_order{nullptr};
+
+        OrderSnapshots() = default;
+        OrderSnapshots(const OrderSnapshots&) = delete;
+
+        ~OrderSnapshots() {
+            delete execution_order.load();
+            delete forward_execution_order.load();
+            delete backward_execution_order.load();
+        }
+    };  // inner struct OrderSnapshots
+
+    /**
+     * Symbol tables and execution order.
+     * Shared between copies of the status. The members are persistent, hence a modification only copies the modified paths.
+     * Lookups read the current tables without locking. Modifications are published by replacing the tables.
+     */
+    struct Tables {
+        // Handles are dense and never reused.
+        utils::PersistentMap<std::string, TensorId>   tensor_ids;
+        utils::PersistentMap<std::string, OperatorId> operator_ids;
+        utils::PersistentSequence<std::string> tensor_names;
+        utils::PersistentSequence<std::string> operator_names;
+        utils::PersistentSequence<std::string> execution_order;
+        // Position of each operator in the execution order, indexed by operator handle.
+        utils::PersistentMap<OperatorId, size_t> execution_positions;
+        // Forward and backward propagation sub-sequences of the execution order.
+        utils::PersistentSequence<std::string> forward_execution_order;
+        utils::PersistentSequence<std::string> backward_execution_order;
+        // Replaced whenever the execution order is modified.
+        std::shared_ptr<OrderSnapshots> order_snapshots = std::make_shared<OrderSnapshots>();
+        std::string operator_entry = "";
+    };  // inner struct Tables
+
+    /**
+     * Pin the current tables and holds during a lookup, so that they are not reclaimed.
+     */
+    struct TablesReader final {
+    private:
+        std::atomic<size_t>& readers;
+        const Tables* target;
+
+    public:
+        TablesReader(std::atomic<size_t>& _readers, const std::atomic<Tables*>& tables): readers(_readers) {
+            ++readers;
+            target = tables.load();
+        }
+        TablesReader(const TablesReader&) = delete;
+
+        inline const Tables& operator*() const noexcept { return *target; }
+        inline const Tables* operator->() const noexcept { return target; }
+
+        ~TablesReader() { --readers; }
+    };  // inner struct TablesReader
+
 public:
     using TensorView   = View<TensorPres>;
     using OperatorView = View<OperatorPres>;
+    using ConstTensorView   = View<ConstTensorPres>;
+    using ConstOperatorView = View<ConstOperatorPres>;
 
 private:
-    std::unordered_map<std::string, Hold<Tensor>> tensor_statuses;
-    std::unordered_map<std::string, Hold<Operator>> operator_statuses;
-    std::vector<std::string> execution_order;
-    std::string operator_entry = "";
-
-    // Protect the status map.
-    // std::shared_mutex tm, om;
+    // Owner of the current tables, only accessed by the writers.
+    std::shared_ptr<Tables> tables = std::make_shared<Tables>();
+    // Tables for lookups.
+    std::atomic<Tables*> current_tables{tables.get()};
+    // Replaced tables and holds which may be still read by the lookups, reclaimed when no lookup is in progress.
+    std::vector<std::shared_ptr<const void>> retired;
+    mutable std::atomic<size_t> readers{0};
+    // Serialize the writers.
+    mutable std::mutex tables_m;
+    // If the status is accessed concurrently while being modified.
+    std::atomic<bool> concurrent{false};
+
+    // Holds of unregistered tensors and operators are left empty.
+    Slots<Tensor>   tensor_slots;
+    Slots<Operator> operator_slots;
+    // Generation of the holds created by this status, replaced with tables_m locked.
+    mutable std::shared_ptr<const Generation> generation = std::make_shared<Generation>();
+    mutable std::atomic<const Generation*> current_generation{generation.get()};
+    // Bumped on every modification of the tables.
+    std::atomic<size_t> version{0};
 
     MemoryInfo memory_info;
+    MemoryAccounting accounting;
+
+    inline TablesReader readTables() const noexcept { return TablesReader(readers, current_tables); }
+
+    /**
+     * Start a new generation, invoked with tables_m locked.
+     */
+    void renewGeneration() const {
+        generation = std::make_shared<Generation>();
+        current_generation.store(generation.get());
+    }
+
+    /**
+     * Tables to be modified, invoked with tables_m locked.
+     * Modified in place only if neither shared with other copies nor concurrently accessed.
+     * Otherwise copied, which only copies the roots of the persistent members.
+     */
+    std::shared_ptr<Tables> prepareTables() const {
+        if (!concurrent && tables.use_count() == 1) return tables;
+        return std::make_shared<Tables>(*tables);
+    }
+
+    /**
+     * Release the retired tables if no lookup is in progress, invoked with tables_m locked.
+     * A lookup starting later reads the current tables, since the tables are not replaced while tables_m locked.
+     */
+    void reclaimTables() {
+        if (readers.load() == 0) retired.clear();
+    }
+
+    /**
+     * Publish the modified tables, invoked with tables_m locked.
+     */
+    void publishTables(std::shared_ptr<Tables> _tables) {
+        if (_tables != tables) {
+            retired.push_back(std::move(tables));
+            tables = std::move(_tables);
+            current_tables.store(tables.get());
+        }
+        reclaimTables();
+        ++version;
+    }
+
+    /**
+     * Locate the hold without locking.
+     */
+    template <typename T>
+    std::shared_ptr<Hold<T>> locateHold(const Slots<T>& slots, size_t index, const char* message) const {
+        TablesReader t = readTables();
+        Hold<T>* hold = slots.load(index);
+        if (hold == nullptr) throw status_exception(message);
+        // The hold is kept alive by the slots or the retired holds while pinned.
+        return hold->shared_from_this();
+    }
+
+    template <typename T>
+    inline bool isHoldCurrent(const Slots<T>& slots, size_t index, const std::shared_ptr<Hold<T>>& hold) const noexcept {
+        return slots.load(index) == hold.get() && hold->generation.get() == current_generation.load();
+    }
+
+    /**
+     * Detach the hold shared with the other status copies, by replacing it with a copy of the current generation.
+     * The target is copied with the hold locked for reading, so that an in-flight modification is not lost.
+     * @return false if not blocking and the hold is being modified
+     */
+    template <typename T>
+    bool detachHold(Slots<T>& slots, size_t index, const std::shared_ptr<Hold<T>>& hold, bool blocking) {
+        std::shared_lock<std::shared_mutex> hl{hold->m, std::try_to_lock};
+        if (!hl.owns_lock()) {
+            // The shared hold is referenced, since the source status was referenced while copying.
+            if (!blocking) return false;
+            hl.lock();
+        }
+        std::shared_ptr<Hold<T>> detached = std::make_shared<Hold<T>>(hold->target, nullptr);
+        hl.unlock();
+
+        std::unique_lock<std::mutex> tl{tables_m};
+        // Detached or unregistered by others meanwhile.
+        if (slots.load(index) != hold.get()) return true;
+        detached->generation = generation;
+        retired.push_back(slots.set(index, std::move(detached)));
+        reclaimTables();
+        return true;
+    }
+
+    /**
+     * Reference the hold, detaching it from the other status copies first.
+     * The hold is validated again after locked, since it may be detached or unregistered meanwhile.
+     * If not blocking, the presentation is left unreferenced instead of waiting for the hold.
+     */
+    template <typename P, typename T, typename... Args>
+    P referenceHold(Slots<T>& slots, size_t index, bool blocking, const char* message, Args&... args) {
+        while (true) {
+            std::shared_ptr<Hold<T>> hold = locateHold(slots, index, message);
+            if (hold->generation.get() != current_generation.load()) {
+                if (!detachHold(slots, index, hold, blocking)) return P(hold->target, hold->m, std::defer_lock, hold, args...);
+                continue;
+            }
+
+            P pres(hold->target, hold->m, hold, args...);
+            if (!pres.isReferenced()) {
+                if (!blocking) return pres;
+                pres.reference();
+            }
+            if (isHoldCurrent(slots, index, hold)) return pres;
+        }
+    }
+
+    /**
+     * Reference the hold while registering, invoked with tables_m locked.
+     */
+    template <typename P, typename T, typename... Args>
+    P referenceHoldLocked(Slots<T>& slots, size_t index, Args&... args) {
+        std::shared_ptr<Hold<T>> hold = slots.get(index);
+        if (hold->generation != generation) {
+            std::shared_lock<std::shared_mutex> hl{hold->m};
+            std::shared_ptr<Hold<T>> detached = std::make_shared<Hold<T>>(hold->target, generation);
+            hl.unlock();
+            retired.push_back(slots.set(index, detached));
+            hold = std::move(detached);
+        }
+        P pres(hold->target, hold->m, hold, args...);
+        if (!pres.isReferenced()) pres.reference();
+        return pres;
+    }
+
+    /**
+     * Snapshot of the execution order, built from the current tables on the first reading.
+     */
+    utils::SnapshotView<std::string> snapshotOrder(
+        const utils::PersistentSequence<std::string> Tables::* order,
+        std::atomic<const std::vector<std::string>*> OrderSnapshots::* snapshot
+    ) const {
+        TablesReader t = readTables();
+        std::shared_ptr<OrderSnapshots> snapshots = t->order_snapshots;
+        std::atomic<const std::vector<std::string>*>& target = (*snapshots).*snapshot;
+        const std::vector<std::string>* re = target.load();
+        if (re == nullptr) {
+            const std::vector<std::string>* built = new std::vector<std::string>(((*t).*order).toVector());
+            if (target.compare_exchange_strong(re, built)) re = built;
+            else delete built;
+        }
+        return utils::SnapshotView<std::string>(std::shared_ptr<const std::vector<std::string>>(std::move(snapshots), re));
+    }
+
+    void appendExecutionIndex(Tables& t, const Operator& op) {
+        t.execution_positions.set(op.id, t.execution_order.size() - 1);
+        if (op.isBackwardPropagation()) t.backward_execution_order.push_back(op.name);
+        else t.forward_execution_order.push_back(op.name);
+        t.order_snapshots = std::make_shared<OrderSnapshots>();
+    }
+
+    void rebuildExecutionIndex(Tables& t) {
+        t.execution_positions = utils::PersistentMap<OperatorId, size_t>();
+        t.forward_execution_order  = utils::PersistentSequence<std::string>();
+        t.backward_execution_order = utils::PersistentSequence<std::string>();
+        for (size_t i = 0; i < t.execution_order.size(); ++i) {
+            const OperatorId* p = t.operator_ids.find(t.execution_order[i]);
+            if (p == nullptr) throw status_exception("Operator not registered.");
+            const Operator& op = operator_slots.get(*p)->target;
+            t.execution_positions.set(op.id, i);
+            if (op.isBackwardPropagation()) t.backward_execution_order.push_back(op.name);
+            else t.forward_execution_order.push_back(op.name);
+        }
+        t.order_snapshots = std::make_shared<OrderSnapshots>();
+    }
+
+    size_t locateExecutionPosition(const std::string& op) const {
+        return getExecutionPosition(getOperatorId(op));
+    }
 
 public:
     MemoryStatus() = default;
-    MemoryStatus(const MemoryStatus& _status) = default;
-    MemoryStatus(MemoryStatus&& _status) {
-        // std::unique_lock<std::shared_mutex> tl{_status.tm};
-        // std::unique_lock<std::shared_mutex> ol{_status.om};
-        tensor_statuses = std::move(_status.tensor_statuses);
-        operator_statuses = std::move(_status.operator_statuses);
-        execution_order = std::move(_status.execution_order);
-        operator_entry = std::move(_status.operator_entry);
+    MemoryStatus(const MemoryStatus& _status) { *this = _status; }
+    MemoryStatus(MemoryStatus&& _status) { *this = std::move(_status); }
+
+    /**
+     * Copying a status shares the tables and the tensor and operator status with the source.
+     * The shared parts are copied on modification, hence the copy behaves as an independent snapshot.
+     * The source should not be referenced while copying, e.g. at the start of the frontend or between registrations.
+     */
+    MemoryStatus& operator=(const MemoryStatus& _status) {
+        if (this == &_status) return *this;
+        std::scoped_lock tl{tables_m, _status.tables_m};
+        // The holds shared by both the statuses are detached on modification.
+        _status.renewGeneration();
+        renewGeneration();
+        for (auto &x : tensor_slots.assign(_status.tensor_slots.getOwners())) retired.push_back(std::move(x));
+        for (auto &x : operator_slots.assign(_status.operator_slots.getOwners())) retired.push_back(std::move(x));
+        publishTables(_status.tables);
+        version = _status.version.load();
         memory_info = _status.memory_info;
+        accounting = _status.accounting;
+        return *this;
     }
-
-    MemoryStatus& operator=(const MemoryStatus& _status) = default;
     MemoryStatus& operator=(MemoryStatus&& _status) {
-        // std::unique_lock<std::shared_mutex> tl{_status.tm};
-        // std::unique_lock<std::shared_mutex> ol{_status.om};
-        tensor_statuses = std::move(_status.tensor_statuses);
-        operator_statuses = std::move(_status.operator_statuses);
-        execution_order = std::move(_status.execution_order);
-        operator_entry = std::move(_status.operator_entry);
+        if (this == &_status) return *this;
+        std::scoped_lock tl{tables_m, _status.tables_m};
+        std::shared_ptr<Tables> _tables = std::move(_status.tables);
+        _status.tables = std::make_shared<Tables>();
+        _status.current_tables.store(_status.tables.get(), std::memory_order_release);
+        // The holds are moved with the generation.
+        generation = std::move(_status.generation);
+        current_generation.store(generation.get());
+        _status.renewGeneration();
+        for (auto &x : tensor_slots.assign(_status.tensor_slots.assign({}))) retired.push_back(std::move(x));
+        for (auto &x : operator_slots.assign(_status.operator_slots.assign({}))) retired.push_back(std::move(x));
+        publishTables(std::move(_tables));
+        version = _status.version.load();
         memory_info = _status.memory_info;
+        accounting = _status.accounting;
         return *this;
     }
 
     void setMemoryInfo(const MemoryInfo& _memory_info) { memory_info = _memory_info; }
     MemoryInfo getMemoryInfo() const { return memory_info; }
 
+    /**
+     * Byte totals of the resident data, updated by the tensor presentations.
+     * Copies of the status hold the totals at the time of copying.
+     */
+    inline const MemoryAccounting& getAccounting() const noexcept { return accounting; }
+    inline MemoryAccounting& getAccounting() noexcept { return accounting; }
+
+    /**
+     * Version of the status structure.
+     * Statuses with the same version share the same registered tensors, operators and execution order.
+     */
+    inline size_t getVersion() const noexcept { return version.load(); }
+
+    /**
+     * setConcurrent
+     * Set if the status is referenced concurrently while tensors and operators are registered,
+     * e.g. after the frontend started. Concurrent modifications copy the tables instead of modifying in place.
+     */
+    inline void setConcurrent(bool _concurrent) noexcept { concurrent = _concurrent; }
+    inline bool isConcurrent() const noexcept { return concurrent; }
+
+    /**
+     * reclaim
+     * Release the tables replaced by modifications, if no lookup is in progress.
+     * Lookup results are values, hence they remain valid after reclaiming.
+     */
+    void reclaim() {
+        std::unique_lock<std::mutex> l{tables_m};
+        reclaimTables();
+    }
+
     /**
      * registerTensor
      * Register a tensor to the storage.
      * Only can be invoked when tensor status storage not inited.
      * @param status tensorStatus
+     * @return handle of the tensor
      */
-    void registerTensor(const Tensor& status) {
-        // std::unique_lock<std::shared_mutex> l{tm};
-
-        auto p = tensor_statuses.find(status.getName());
-        if (p != tensor_statuses.end()) throw status_exception("Tensor already registered.");
-        tensor_statuses.emplace(status.getName(), status);
+    TensorId registerTensor(const Tensor& status) {
+        std::unique_lock<std::mutex> tl{tables_m};
+        if (tables->tensor_ids.contains(status.getName())) throw status_exception("Tensor already registered.");
+
+        std::shared_ptr<Tables> t = prepareTables();
+        std::shared_ptr<Hold<Tensor>> hold = std::make_shared<Hold<Tensor>>(status, generation);
+        TensorId id = tensor_slots.size();
+        hold->target.id = id;
+        tensor_slots.push_back(std::move(hold));
+
+        t->tensor_ids.set(status.getName(), id);
+        t->tensor_names.push_back(status.getName());
+        publishTables(std::move(t));
+        return id;
     }
 
     /**
@@ -746,14 +1565,9 @@ public:
      * Register a tensor to the storage, whose status information is empty.
      * Only can be invoked when tensor status storage not inited.
      * @param tensor tensor name
+     * @return handle of the tensor
      */
-    void registerTensor(const std::string& tensor) {
-        // std::unique_lock<std::shared_mutex> l{tm};
-
-        auto p = tensor_statuses.find(tensor);
-        if (p != tensor_statuses.end()) throw status_exception("Tensor already registered.");
-        tensor_statuses.emplace(tensor, Tensor(tensor));
-    }
+    inline TensorId registerTensor(const std::string& tensor) { return registerTensor(Tensor(tensor)); }
 
     /**
      * registerOperator
@@ -761,68 +1575,124 @@ public:
      * An operator should be always registered later than its tensors,
      * since the status storage would check the validity of the tensors included in the operator.
      * @param status operator status
+     * @return handle of the operator
      */
-    void registerOperator(const Operator& status) {
-        // std::unique_lock<std::shared_mutex> l{om};
-
-        auto p = operator_statuses.find(status.getName());
-        if (p != operator_statuses.end()) throw status_exception("Operator already registered.");
+    OperatorId registerOperator(const Operator& status) {
+        std::unique_lock<std::mutex> tl{tables_m};
+        if (tables->operator_ids.contains(status.getName())) throw status_exception("Operator already registered.");
 
-        for (auto &s : status.getTensors()) {
-            if (tensor_statuses.find(s) == tensor_statuses.end())
+        for (auto &s : status.getTensors())
+            if (!tables->tensor_ids.contains(s))
                 // Tensor not registered.
                 throw status_exception("Specified tensor not registered.");
-            // Set operator information for tensor.
-            tensor_statuses.at(s).target.op = status.getName();
-        }
 
         for (auto &s : status.getPrevs())
-            if (operator_statuses.find(s) == operator_statuses.end())
+            if (!tables->operator_ids.contains(s))
                 // Operator not registered.
                 throw status_exception("Specified prev operator not registered.");
 
-        operator_statuses.emplace(status.getName(), status);
-        execution_order.push_back(status.getName());
+        std::shared_ptr<Tables> t = prepareTables();
+        std::shared_ptr<Hold<Operator>> hold = std::make_shared<Hold<Operator>>(status, generation);
+        Operator& target = hold->target;
+        target.tensor_ids.clear();
+        OperatorId id = operator_slots.size();
+        target.id = id;
+
+        for (auto &s : target.tensors) {
+            // Set operator information for tensor. The tensor may be referenced if the status is concurrently accessed.
+            TensorPres pres = referenceHoldLocked<TensorPres>(tensor_slots, *t->tensor_ids.find(s), accounting);
+            Tensor& tensor = pres.get();
+            tensor.op    = target.name;
+            tensor.op_id = id;
+            target.tensor_ids.push_back(tensor.id);
+        }
+        std::sort(target.tensor_ids.begin(), target.tensor_ids.end());
+        operator_slots.push_back(std::move(hold));
+
+        t->operator_ids.set(status.getName(), id);
+        t->operator_names.push_back(status.getName());
+        t->execution_order.push_back(status.getName());
+        appendExecutionIndex(*t, target);
+        publishTables(std::move(t));
+        return id;
     }
 
     void setEntry(const std::string& _op) {
-        auto p = operator_statuses.find(_op);
-        if (p == operator_statuses.end()) throw status_exception("Operator not registered.");
-        operator_entry = _op;
+        std::unique_lock<std::mutex> tl{tables_m};
+        if (!tables->operator_ids.contains(_op)) throw status_exception("Operator not registered.");
+        std::shared_ptr<Tables> t = prepareTables();
+        t->operator_entry = _op;
+        publishTables(std::move(t));
+    }
+
+    inline std::string getEntry() const noexcept { return readTables()->operator_entry; }
+
+    /**
+     * The execution order is returned as a contiguous snapshot, which is not affected by later modifications.
+     * The snapshot is built once per modification of the execution order, and shared by the readers.
+     */
+    inline utils::SnapshotView<std::string> getExecutionOrder() const {
+        return snapshotOrder(&Tables::execution_order, &OrderSnapshots::execution_order);
     }
 
-    inline std::string getEntry() const noexcept { return operator_entry; }
+    /**
+     * Sub-sequences of the execution order, split by the backward propagation flag of the operators at registration.
+     */
+    inline utils::SnapshotView<std::string> getForwardExecutionOrder() const {
+        return snapshotOrder(&Tables::forward_execution_order, &OrderSnapshots::forward_execution_order);
+    }
+    inline utils::SnapshotView<std::string> getBackwardExecutionOrder() const {
+        return snapshotOrder(&Tables::backward_execution_order, &OrderSnapshots::backward_execution_order);
+    }
 
-    inline std::vector<std::string> getExecutionOrder() const noexcept { return execution_order; }
+    /**
+     * getExecutionPosition
+     * Position of the operator in the execution order.
+     * @param op operator name or handle
+     * @return position of the operator
+     */
+    inline size_t getExecutionPosition(const std::string& op) const { return locateExecutionPosition(op); }
+    size_t getExecutionPosition(OperatorId op) const {
+        const size_t* posi = readTables()->execution_positions.find(op);
+        if (posi == nullptr) throw status_exception("Operator not registered.");
+        return *posi;
+    }
+
+    /**
+     * getExecutionDistance
+     * Count of operators from one operator to another in the execution order.
+     * @return distance, negative if the target operator is executed earlier
+     */
+    inline long getExecutionDistance(const std::string& from, const std::string& to) const {
+        return static_cast<long>(locateExecutionPosition(to)) - static_cast<long>(locateExecutionPosition(from));
+    }
 
     inline bool hasExecutionPost(const std::string& op) const {
-        auto p = std::find(execution_order.begin(), execution_order.end(), op);
-        if (p == execution_order.end()) throw status_exception("Operator not registered.");
-        return ++p != execution_order.end();
+        return locateExecutionPosition(op) + 1 < readTables()->execution_order.size();
     }
     inline std::string getExecutionPost(const std::string& op) const {
-        auto p = std::find(execution_order.begin(), execution_order.end(), op);
-        if (p == execution_order.end()) throw status_exception("Operator not registered.");
-        if (++p == execution_order.end()) return "";
-        return *p;
+        size_t posi = locateExecutionPosition(op);
+        TablesReader t = readTables();
+        if (posi + 1 >= t->execution_order.size()) return "";
+        return t->execution_order[posi + 1];
     }
 
     inline bool hasExecutionPrev(const std::string& op) const {
-        auto p = std::find(execution_order.begin(), execution_order.end(), op);
-        if (p == execution_order.end()) throw status_exception("Operator not registered.");
-        return p != execution_order.begin();
+        return locateExecutionPosition(op) != 0;
     }
     inline std::string getExecutionPrev(const std::string& op) const {
-        auto p = std::find(execution_order.begin(), execution_order.end(), op);
-        if (p == execution_order.end()) throw status_exception("Operator not registered.");
-        if (p == execution_order.begin()) return "";
-        return *--p;
+        size_t posi = locateExecutionPosition(op);
+        if (posi == 0) return "";
+        return readTables()->execution_order[posi - 1];
     }
 
     template<typename T>
     inline void setExecutionOrder(const T& _execution_order) { 
-        std::vector<std::string> vect(begin(_execution_order), end(_execution_order));
-        execution_order.swap(vect);
+        std::unique_lock<std::mutex> tl{tables_m};
+        std::shared_ptr<Tables> t = prepareTables();
+        t->execution_order = utils::PersistentSequence<std::string>(begin(_execution_order), end(_execution_order));
+        rebuildExecutionIndex(*t);
+        publishTables(std::move(t));
     }
 
     /**
@@ -832,7 +1702,11 @@ public:
      * @return if the tensor is registered
      */
     bool isTensorRegistered(const std::string& tensor) const {
-        return tensor_statuses.find(tensor) != tensor_statuses.end();
+        return readTables()->tensor_ids.contains(tensor);
+    }
+    bool isTensorRegistered(TensorId tensor) const {
+        // The hold is not read, hence the lookup need not be pinned.
+        return tensor_slots.load(tensor) != nullptr;
     }
 
     /**
@@ -842,73 +1716,194 @@ public:
      * @return if the operator is registered
      */
     bool isOperatorRegistered(const std::string& op) const {
-        return operator_statuses.find(op) != operator_statuses.end();
+        return readTables()->operator_ids.contains(op);
+    }
+    bool isOperatorRegistered(OperatorId op) const {
+        // The hold is not read, hence the lookup need not be pinned.
+        return operator_slots.load(op) != nullptr;
     }
 
-    TensorView tryReferenceTensor(const std::string& tensor) {
-        auto p = tensor_statuses.find(tensor);
-        if (p == tensor_statuses.end()) throw status_exception("Tensor not registered.");
-        return TensorView(p->second.target, p->second.m);
+    /**
+     * Translate between tensor names and handles.
+     * Name lookups are intended for registration time. Handles should be cached by the caller.
+     * Names of unregistered handles remain resolvable, for exporting the past events.
+     */
+    TensorId getTensorId(const std::string& tensor) const {
+        TablesReader t = readTables();
+        const TensorId* p = t->tensor_ids.find(tensor);
+        if (p == nullptr) throw status_exception("Tensor not registered.");
+        return *p;
+    }
+    inline std::string getTensorName(TensorId tensor) const {
+        TablesReader t = readTables();
+        if (tensor >= t->tensor_names.size()) throw status_exception("Tensor not registered.");
+        return t->tensor_names[tensor];
+    }
+
+    /**
+     * Translate between operator names and handles.
+     * The name of invalid_id is empty, which stands for the memory events submitted without operator.
+     */
+    OperatorId getOperatorId(const std::string& op) const {
+        TablesReader t = readTables();
+        const OperatorId* p = t->operator_ids.find(op);
+        if (p == nullptr) throw status_exception("Operator not registered.");
+        return *p;
+    }
+    std::string getOperatorName(OperatorId op) const {
+        if (op == invalid_id) return "";
+        TablesReader t = readTables();
+        if (op >= t->operator_names.size()) throw status_exception("Operator not registered.");
+        return t->operator_names[op];
+    }
+
+    inline TensorView tryReferenceTensor(const std::string& tensor) { return tryReferenceTensor(getTensorId(tensor)); }
+    TensorView tryReferenceTensor(TensorId tensor) {
+        return TensorView(
+            referenceHold<TensorPres>(tensor_slots, tensor, false, "Tensor not registered.", accounting),
+            [this, tensor]() { return referenceTensor(tensor); }
+        );
     }
 
     /**
      * Reference the tensor
-     * @param tensor tensor name
+     * @param tensor tensor name or handle
      * @return reference to the specific tensor
      */
     inline TensorPres referenceTensor(const std::string& tensor) { return tryReferenceTensor(tensor).reference(); }
-
-    OperatorView tryReferenceOperator(const std::string& op) {
-        auto p = operator_statuses.find(op);
-        if (p == operator_statuses.end()) throw status_exception("Operator not registered.");
-        return OperatorView(p->second.target, p->second.m);
+    inline TensorPres referenceTensor(TensorId tensor) { return referenceHold<TensorPres>(tensor_slots, tensor, true, "Tensor not registered.", accounting); }
+
+    inline OperatorView tryReferenceOperator(const std::string& op) { return tryReferenceOperator(getOperatorId(op)); }
+    OperatorView tryReferenceOperator(OperatorId op) {
+        return OperatorView(
+            referenceHold<OperatorPres>(operator_slots, op, false, "Operator not registered."),
+            [this, op]() { return referenceOperator(op); }
+        );
     }
 
     inline OperatorPres referenceOperator(const std::string& op) { return tryReferenceOperator(op).reference(); }
+    inline OperatorPres referenceOperator(OperatorId op) { return referenceHold<OperatorPres>(operator_slots, op, true, "Operator not registered."); }
 
-    inline std::unordered_set<std::string> getTensors() const {
-        std::unordered_set<std::string> re;
-        for (auto &x : tensor_statuses) re.insert(x.first);
-        return re;
+    inline ConstTensorView tryReferenceConstTensor(const std::string& tensor) const { return tryReferenceConstTensor(getTensorId(tensor)); }
+    ConstTensorView tryReferenceConstTensor(TensorId tensor) const {
+        // Reading does not detach the shared status.
+        std::shared_ptr<Hold<Tensor>> hold = locateHold(tensor_slots, tensor, "Tensor not registered.");
+        return ConstTensorView(hold->target, hold->m, hold);
     }
-    inline std::unordered_set<std::string> getOperators() const {
-        std::unordered_set<std::string> re;
-        for (auto &x : operator_statuses) re.insert(x.first);
-        return re;
+
+    /**
+     * Reference the tensor for reading.
+     * Read-only references share the tensor with each other, and are exclusive only with referenceTensor.
+     * @param tensor tensor name or handle
+     * @return read-only reference to the specific tensor
+     */
+    inline ConstTensorPres referenceConstTensor(const std::string& tensor) const { return tryReferenceConstTensor(tensor).reference(); }
+    inline ConstTensorPres referenceConstTensor(TensorId tensor) const { return tryReferenceConstTensor(tensor).reference(); }
+
+    inline ConstOperatorView tryReferenceConstOperator(const std::string& op) const { return tryReferenceConstOperator(getOperatorId(op)); }
+    ConstOperatorView tryReferenceConstOperator(OperatorId op) const {
+        std::shared_ptr<Hold<Operator>> hold = locateHold(operator_slots, op, "Operator not registered.");
+        return ConstOperatorView(hold->target, hold->m, hold);
     }
 
-    void unregisterOperator(const std::string& op) {
-        // std::unique_lock<std::shared_mutex> l{om};
-        
-        auto p = operator_statuses.find(op);
-        if (p == operator_statuses.end()) throw status_exception("Operator not registered.");
-        operator_statuses.erase(p);
+    inline ConstOperatorPres referenceConstOperator(const std::string& op) const { return tryReferenceConstOperator(op).reference(); }
+    inline ConstOperatorPres referenceConstOperator(OperatorId op) const { return tryReferenceConstOperator(op).reference(); }
 
-        auto q = std::find(execution_order.begin(), execution_order.end(), op);
-        assert(q != execution_order.end());
-        execution_order.erase(q);
+    /**
+     * Names of the registered tensors and operators, in no particular order.
+     * The views share the name tables of the moment they are taken, hence stay valid during later registrations.
+     */
+    inline utils::KeyView<utils::PersistentMap<std::string, TensorId>> getTensors() const { return readTables()->tensor_ids; }
+    inline utils::KeyView<utils::PersistentMap<std::string, OperatorId>> getOperators() const { return readTables()->operator_ids; }
+
+    /**
+     * unregisterOperator
+     * Unregister an operator from the storage.
+     * In-flight presentations of the operator remain valid.
+     * @param op operator name
+     */
+    void unregisterOperator(const std::string& op) {
+        std::unique_lock<std::mutex> tl{tables_m};
+        const OperatorId* p = tables->operator_ids.find(op);
+        if (p == nullptr) throw status_exception("Operator not registered.");
+        OperatorId id = *p;
+        // The operator may be left out of the execution order by setExecutionOrder.
+        const size_t* posi = tables->execution_positions.find(id);
+
+        std::shared_ptr<Tables> t = prepareTables();
+        t->operator_ids.erase(op);
+        retired.push_back(operator_slots.set(id, nullptr));
+
+        if (posi != nullptr) {
+            // Removing from the middle rebuilds the execution order. Unregistration is rare compared with registration.
+            std::vector<std::string> execution_order = t->execution_order.toVector();
+            execution_order.erase(execution_order.begin() + *posi);
+            t->execution_order = utils::PersistentSequence<std::string>(execution_order.begin(), execution_order.end());
+            rebuildExecutionIndex(*t);
+        }
+        publishTables(std::move(t));
     }
 
     /**
      * unregisterTensor
-     * Unregister a tensor from the storage.
-     * Only can be invoked when tensor status storage not inited.
+     * Unregister a tensor from the storage, and remove it from the operator it belongs to.
+     * In-flight presentations of the tensor remain valid.
      * @param tensor tensor name
     */
     void unregisterTensor(const std::string& tensor) {
-        // std::unique_lock<std::shared_mutex> l{tm};
-        
-        auto p = tensor_statuses.find(tensor);
-        if (p == tensor_statuses.end()) throw status_exception("Tensor not registered.");
-        tensor_statuses.erase(p);
+        std::unique_lock<std::mutex> tl{tables_m};
+        const TensorId* p = tables->tensor_ids.find(tensor);
+        if (p == nullptr) throw status_exception("Tensor not registered.");
+        TensorId id = *p;
+
+        std::shared_ptr<Tables> t = prepareTables();
+        t->tensor_ids.erase(tensor);
+        std::shared_ptr<Hold<Tensor>> hold = tensor_slots.set(id, nullptr);
+        retired.push_back(hold);
+
+        // Remove the resident data of the tensor from accounting.
+        std::shared_lock<std::shared_mutex> l{hold->m};
+        OperatorId op = hold->target.getOperatorId();
+        accounting.update(hold->target.getBlockType(), hold->target.getDeviceResidentSize(), 0, hold->target.getHostResidentSize(), 0);
+        l.unlock();
+
+        if (op < operator_slots.size() && operator_slots.get(op)) {
+            OperatorPres pres = referenceHoldLocked<OperatorPres>(operator_slots, op);
+            Operator& target = pres.get();
+            target.tensors.erase(tensor);
+            auto q = std::lower_bound(target.tensor_ids.begin(), target.tensor_ids.end(), id);
+            if (q != target.tensor_ids.end() && *q == id) target.tensor_ids.erase(q);
+        }
+
+        publishTables(std::move(t));
+    }
+
+    /**
+     * apply
+     * Apply the delta of the source status, which this status is copied from.
+     * Handles are assigned in the same order as the source, otherwise the delta is out of order.
+     * @param delta delta of the source status
+     */
+    void apply(const MemoryStatusDelta& delta) {
+        for (auto &x : delta.unregistered_operators) unregisterOperator(x);
+        for (auto &x : delta.unregistered_tensors) unregisterTensor(x);
+        for (auto &x : delta.registered_tensors) {
+            if (registerTensor(x) != x.getId()) throw status_exception("Status delta out of order.");
+        }
+        for (auto &x : delta.registered_operators) {
+            if (registerOperator(x) != x.getId()) throw status_exception("Status delta out of order.");
+        }
     }
 
     /**
      * @brief Clear all status information.
     */
     void clear() {
-        tensor_statuses.clear();
-        operator_statuses.clear();
+        std::unique_lock<std::mutex> tl{tables_m};
+        for (auto &x : tensor_slots.assign({})) retired.push_back(std::move(x));
+        for (auto &x : operator_slots.assign({})) retired.push_back(std::move(x));
+        accounting = MemoryAccounting();
+        publishTables(std::make_shared<Tables>());
     }
 
     ~MemoryStatus() = default;
@@ -939,10 +1934,13 @@ static std::string get_tensor_type_str(MemoryDataType type) {
 
 using TensorView   = status::MemoryStatus::TensorView;
 using OperatorView = status::MemoryStatus::OperatorView;
+using ConstTensorView   = status::MemoryStatus::ConstTensorView;
+using ConstOperatorView = status::MemoryStatus::ConstOperatorView;
 
 }   // namespace status
 
-using TensorPres   = status::TensorPres;
-using MemoryStatus = status::MemoryStatus;
+using TensorPres      = status::TensorPres;
+using ConstTensorPres = status::ConstTensorPres;
+using MemoryStatus    = status::MemoryStatus;
 
 }   // namespace mori
\ No newline at end of file
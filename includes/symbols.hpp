@@ -1,5 +1,9 @@
 #pragma once
 
+#include <string>
+#include <cstddef>
+#include <limits>
+
 namespace mori {
 
 enum struct ApplicationStage {
@@ -10,6 +14,21 @@ enum struct Direction {
     prev, post
 };  // enum struct Direction
 
+/**
+ * Dense handles of tensors and operators.
+ * Handed out by MemoryStatus at registration, hence string names are only touched at registration and export time.
+ */
+using TensorId   = size_t;
+using OperatorId = size_t;
+
+/**
+ * Index of devices in MemoryInfo. The primary device is 0, and the peer devices follow.
+ */
+using DeviceId   = size_t;
+
+// Handle for unregistered (or unspecified) tensors and operators.
+static constexpr size_t invalid_id = std::numeric_limits<size_t>::max();
+
 namespace utils {
 
 static std::string get_application_stage_str(ApplicationStage stage) {
@@ -22,5 +41,10 @@ static std::string get_application_stage_str(ApplicationStage stage) {
     return "";
 }
 
+static std::string get_id_str(size_t id) {
+    if (id == invalid_id) return "";
+    return "#" + std::to_string(id);
+}
+
 }   // namespace utils
-}   // namespace mori
\ No newline at end of file
+}   // namespace mori
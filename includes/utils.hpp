@@ -4,12 +4,36 @@
 #include <string>
 #include <cmath>
 #include <sstream>
+#include <iterator>
+#include <cstddef>
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <array>
+#include <utility>
+#include <functional>
+#include <type_traits>
 
 namespace mori {
 namespace utils {
 
+/**
+ * Timestamps, timespans and timepoints are counted in microseconds of std::chrono::steady_clock.
+ * Milliseconds are only used by the exporters.
+ */
+using TimeUnit = std::chrono::microseconds;
+
 static long get_timestamp_val(const std::chrono::steady_clock::time_point& timestamp) {
-    return std::chrono::duration_cast<std::chrono::milliseconds>(timestamp.time_since_epoch()).count();
+    return std::chrono::duration_cast<TimeUnit>(timestamp.time_since_epoch()).count();
+}
+
+static long get_duration_val(const std::chrono::steady_clock::duration& duration) {
+    return std::chrono::duration_cast<TimeUnit>(duration).count();
+}
+
+inline static long get_millisecond_val(long val) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(TimeUnit(val)).count();
 }
 
 inline static void* address_offset(void* address, size_t size) {
@@ -43,5 +67,405 @@ inline static std::string make_pointer_string_hex(void* address) {
     return ss.str();
 }
 
+/**
+ * KeyView
+ * Read-only range over the keys of an associative container, without copying the keys.
+ * The view keeps a copy of the container, hence it is intended for persistent containers, where the copy shares the
+ * entries and stays valid while the container is modified.
+ */
+template <typename Map>
+struct KeyView final {
+public:
+    struct iterator final {
+    private:
+        typename Map::const_iterator p;
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = typename Map::key_type;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = const value_type*;
+        using reference         = const value_type&;
+
+        iterator(typename Map::const_iterator _p): p(_p) {}
+
+        inline reference operator*() const { return p->first; }
+        inline pointer operator->() const { return &(p->first); }
+        inline iterator& operator++() { ++p; return *this; }
+        inline iterator operator++(int) { iterator re = *this; ++p; return re; }
+        inline bool operator==(const iterator& it) const { return p == it.p; }
+        inline bool operator!=(const iterator& it) const { return p != it.p; }
+    };  // struct iterator
+
+private:
+    Map target;
+
+public:
+    KeyView(const Map& _target): target(_target) {}
+
+    inline iterator begin() const { return iterator(target.begin()); }
+    inline iterator end() const { return iterator(target.end()); }
+    inline size_t size() const noexcept { return target.size(); }
+    inline bool empty() const noexcept { return target.empty(); }
+    inline bool contains(const typename Map::key_type& key) const { return target.contains(key); }
+};  // struct KeyView
+
+/**
+ * NodePool
+ * Free-list pool of fixed-size nodes, carved from chunks that are kept until the pool is destroyed.
+ * The node size is fixed by the first allocation; allocations of other sizes fall back to the global heap.
+ * Not thread-safe; the owner of the container should serialize the accesses.
+ */
+struct NodePool final {
+private:
+    static constexpr size_t chunk_nodes = 64;
+
+    size_t node_size = 0;
+    void*  free_list = nullptr;
+    std::vector<std::unique_ptr<uint8_t[]>> chunks;
+
+    void grow() {
+        chunks.emplace_back(new uint8_t[node_size * chunk_nodes]);
+        uint8_t* chunk = chunks.back().get();
+        for (size_t i = 0; i < chunk_nodes; ++i) {
+            void* node = chunk + i * node_size;
+            *static_cast<void**>(node) = free_list;
+            free_list = node;
+        }
+    }
+
+public:
+    NodePool() = default;
+    NodePool(const NodePool&) = delete;
+    NodePool& operator=(const NodePool&) = delete;
+
+    void* allocate(size_t size) {
+        if (node_size == 0) {
+            constexpr size_t alignment = alignof(std::max_align_t);
+            node_size = (std::max(size, sizeof(void*)) + alignment - 1) / alignment * alignment;
+        }
+        if (size > node_size) return ::operator new(size);
+        if (free_list == nullptr) grow();
+        void* node = free_list;
+        free_list = *static_cast<void**>(node);
+        return node;
+    }
+
+    void deallocate(void* node, size_t size) noexcept {
+        if (size > node_size) return ::operator delete(node);
+        *static_cast<void**>(node) = free_list;
+        free_list = node;
+    }
+
+    /**
+     * Number of chunks requested from the global heap.
+     */
+    inline size_t getChunkCount() const noexcept { return chunks.size(); }
+};  // struct NodePool
+
+/**
+ * PoolAllocator
+ * Allocator for node-based containers backed by a NodePool. Copies and rebinds share the pool.
+ * A copy-constructed container receives a new pool, so containers never share pools unintentionally.
+ */
+template <typename T>
+struct PoolAllocator {
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::false_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap            = std::true_type;
+
+    std::shared_ptr<NodePool> pool;
+
+    PoolAllocator(): pool(std::make_shared<NodePool>()) {}
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U>& allocator) noexcept: pool(allocator.pool) {}
+
+    inline T* allocate(size_t n) {
+        if (n != 1) return static_cast<T*>(::operator new(n * sizeof(T)));
+        return static_cast<T*>(pool->allocate(sizeof(T)));
+    }
+    inline void deallocate(T* p, size_t n) noexcept {
+        if (n != 1) return ::operator delete(p);
+        pool->deallocate(p, sizeof(T));
+    }
+
+    inline PoolAllocator select_on_container_copy_construction() const { return PoolAllocator(); }
+
+    template <typename U>
+    inline bool operator==(const PoolAllocator<U>& allocator) const noexcept { return pool == allocator.pool; }
+    template <typename U>
+    inline bool operator!=(const PoolAllocator<U>& allocator) const noexcept { return pool != allocator.pool; }
+};  // struct PoolAllocator
+
+/**
+ * PersistentMap
+ * Immutable hash trie. Modifications copy the path to the modified leaf and share the rest with the previous version,
+ * hence keeping versions is cheap, and a version can be read while newer versions are being built.
+ */
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+struct PersistentMap final {
+private:
+    static constexpr size_t bits  = 5;
+    static constexpr size_t width = 1 << bits;
+    static constexpr size_t depth_limit    = (sizeof(size_t) * 8 + bits - 1) / bits;
+    static constexpr size_t leaf_capacity  = 8;
+
+    struct Node final {
+        bool leaf = true;
+        std::array<std::shared_ptr<const Node>, width> children;
+        std::vector<std::pair<Key, Value>> entries;
+    };  // inner struct Node
+
+    std::shared_ptr<const Node> root;
+    size_t count = 0;
+
+    static inline size_t slice(size_t hash, size_t depth) noexcept { return (hash >> (depth * bits)) & (width - 1); }
+
+    static std::shared_ptr<const Node> insert(const std::shared_ptr<const Node>& node, size_t depth, size_t hash, const Key& key, const Value& value, bool& inserted) {
+        std::shared_ptr<Node> re = node ? std::make_shared<Node>(*node) : std::make_shared<Node>();
+        if (!re->leaf) {
+            auto& child = re->children[slice(hash, depth)];
+            child = insert(child, depth + 1, hash, key, value, inserted);
+            return re;
+        }
+
+        for (auto &x : re->entries) {
+            if (x.first != key) continue;
+            x.second = value;
+            inserted = false;
+            return re;
+        }
+        re->entries.emplace_back(key, value);
+        inserted = true;
+        if (re->entries.size() <= leaf_capacity || depth + 1 >= depth_limit) return re;
+
+        // Split the leaf.
+        std::shared_ptr<Node> branch = std::make_shared<Node>();
+        branch->leaf = false;
+        bool split = false;
+        for (auto &x : re->entries) {
+            size_t h = Hash{}(x.first);
+            auto& child = branch->children[slice(h, depth)];
+            child = insert(child, depth + 1, h, x.first, x.second, split);
+        }
+        return branch;
+    }
+
+    static std::shared_ptr<const Node> erase(const std::shared_ptr<const Node>& node, size_t depth, size_t hash, const Key& key, bool& erased) {
+        if (!node) return node;
+        if (!node->leaf) {
+            const auto& child = node->children[slice(hash, depth)];
+            std::shared_ptr<const Node> updated = erase(child, depth + 1, hash, key, erased);
+            if (!erased) return node;
+            std::shared_ptr<Node> re = std::make_shared<Node>(*node);
+            re->children[slice(hash, depth)] = std::move(updated);
+            return re;
+        }
+
+        auto p = std::find_if(node->entries.begin(), node->entries.end(), [&key](const std::pair<Key, Value>& x) { return x.first == key; });
+        if (p == node->entries.end()) return node;
+        std::shared_ptr<Node> re = std::make_shared<Node>(*node);
+        re->entries.erase(re->entries.begin() + (p - node->entries.begin()));
+        erased = true;
+        return re;
+    }
+
+    template <typename F>
+    static void visit(const std::shared_ptr<const Node>& node, F&& func) {
+        if (!node) return;
+        if (node->leaf) {
+            for (auto &x : node->entries) func(x.first, x.second);
+            return;
+        }
+        for (auto &x : node->children) visit(x, func);
+    }
+
+public:
+    using key_type = Key;
+
+    /**
+     * Depth-first traversal of the entries, in no particular order.
+     * The path to the current entry is kept inline, since the depth of the trie is bounded.
+     */
+    struct const_iterator final {
+    private:
+        std::array<std::pair<const Node*, size_t>, depth_limit + 1> path;
+        size_t depth = 0;
+
+        // Move to the next entry, starting from the current position of the path.
+        void settle() {
+            while (depth > 0) {
+                auto& top = path[depth - 1];
+                const Node* node = top.first;
+                if (node->leaf) {
+                    if (top.second < node->entries.size()) return;
+                } else if (top.second < width) {
+                    const Node* child = node->children[top.second].get();
+                    if (child == nullptr) ++top.second;
+                    else path[depth++] = std::make_pair(child, size_t(0));
+                    continue;
+                }
+                // The node is visited, return to its parent.
+                if (--depth > 0) ++path[depth - 1].second;
+            }
+        }
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = std::pair<Key, Value>;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = const value_type*;
+        using reference         = const value_type&;
+
+        const_iterator() = default;
+        const_iterator(const Node* root) {
+            if (root == nullptr) return;
+            path[depth++] = std::make_pair(root, size_t(0));
+            settle();
+        }
+
+        inline reference operator*() const { return path[depth - 1].first->entries[path[depth - 1].second]; }
+        inline pointer operator->() const { return &(**this); }
+        inline const_iterator& operator++() {
+            ++path[depth - 1].second;
+            settle();
+            return *this;
+        }
+        inline const_iterator operator++(int) { const_iterator re = *this; ++(*this); return re; }
+        inline bool operator==(const const_iterator& it) const {
+            if (depth == 0 || it.depth == 0) return depth == it.depth;
+            return path[depth - 1] == it.path[it.depth - 1];
+        }
+        inline bool operator!=(const const_iterator& it) const { return !(*this == it); }
+    };  // inner struct const_iterator
+
+public:
+    PersistentMap() = default;
+
+    const Value* find(const Key& key) const {
+        size_t hash = Hash{}(key);
+        const Node* node = root.get();
+        for (size_t depth = 0; node != nullptr && !node->leaf; ++depth) node = node->children[slice(hash, depth)].get();
+        if (node == nullptr) return nullptr;
+        for (auto &x : node->entries) {
+            if (x.first == key) return &x.second;
+        }
+        return nullptr;
+    }
+
+    inline bool contains(const Key& key) const { return find(key) != nullptr; }
+
+    /**
+     * Insert or replace the value of the key.
+     */
+    void set(const Key& key, const Value& value) {
+        bool inserted = false;
+        root = insert(root, 0, Hash{}(key), key, value, inserted);
+        if (inserted) ++count;
+    }
+
+    void erase(const Key& key) {
+        bool erased = false;
+        root = erase(root, 0, Hash{}(key), key, erased);
+        if (erased) --count;
+    }
+
+    /**
+     * Visit the entries in no particular order.
+     */
+    template <typename F>
+    inline void forEach(F&& func) const { visit(root, func); }
+
+    inline const_iterator begin() const { return const_iterator(root.get()); }
+    inline const_iterator end() const { return const_iterator(); }
+
+    inline size_t size() const noexcept { return count; }
+    inline bool empty() const noexcept { return count == 0; }
+};  // struct PersistentMap
+
+/**
+ * PersistentSequence
+ * Immutable sequence for appending, sharing the elements between versions as PersistentMap.
+ */
+template <typename T>
+struct PersistentSequence final {
+private:
+    struct IndexHash final {
+        inline size_t operator()(size_t index) const noexcept { return index; }
+    };  // inner struct IndexHash
+
+    PersistentMap<size_t, T, IndexHash> elements;
+
+public:
+    struct iterator final {
+    private:
+        const PersistentSequence* target;
+        size_t index;
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = T;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = const T*;
+        using reference         = const T&;
+
+        iterator(const PersistentSequence* _target, size_t _index): target(_target), index(_index) {}
+
+        inline reference operator*() const { return (*target)[index]; }
+        inline pointer operator->() const { return &((*target)[index]); }
+        inline iterator& operator++() { ++index; return *this; }
+        inline iterator operator++(int) { iterator re = *this; ++index; return re; }
+        inline bool operator==(const iterator& it) const { return index == it.index; }
+        inline bool operator!=(const iterator& it) const { return index != it.index; }
+    };  // inner struct iterator
+
+public:
+    PersistentSequence() = default;
+    template <typename It>
+    PersistentSequence(It first, It last) { for (; first != last; ++first) push_back(*first); }
+
+    inline const T& operator[](size_t index) const { return *elements.find(index); }
+    inline const T& back() const { return (*this)[size() - 1]; }
+    inline void push_back(const T& value) { elements.set(size(), value); }
+    /**
+     * Replace the element at the index, which should be less than the size.
+     */
+    inline void set(size_t index, const T& value) { elements.set(index, value); }
+
+    inline iterator begin() const { return iterator(this, 0); }
+    inline iterator end() const { return iterator(this, size()); }
+    inline size_t size() const noexcept { return elements.size(); }
+    inline bool empty() const noexcept { return elements.empty(); }
+
+    inline std::vector<T> toVector() const { return std::vector<T>(begin(), end()); }
+};  // struct PersistentSequence
+
+/**
+ * SnapshotView
+ * Read-only range over a contiguous snapshot, keeping the snapshot alive.
+ */
+template <typename T>
+struct SnapshotView final {
+private:
+    std::shared_ptr<const std::vector<T>> target;
+
+public:
+    using iterator = typename std::vector<T>::const_iterator;
+
+public:
+    SnapshotView(std::shared_ptr<const std::vector<T>> _target): target(std::move(_target)) {}
+
+    inline const T& operator[](size_t index) const { return (*target)[index]; }
+    inline const T& back() const { return target->back(); }
+
+    inline iterator begin() const { return target->begin(); }
+    inline iterator end() const { return target->end(); }
+    inline size_t size() const noexcept { return target->size(); }
+    inline bool empty() const noexcept { return target->empty(); }
+
+    inline std::vector<T> toVector() const { return *target; }
+};  // struct SnapshotView
+
 }   // namespace utils
 }   // namespace mori
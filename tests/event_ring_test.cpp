@@ -0,0 +1,76 @@
+#include <cassert>
+#include <iostream>
+#include <thread>
+#include <mutex>
+
+#include "backend/events.hpp"
+
+using namespace mori;
+
+/**
+ * Records of the rings are merged in the order of timestamps.
+ */
+static void testMerge() {
+    events::EventRing ring_1, ring_2;
+    std::chrono::steady_clock::time_point base = std::chrono::steady_clock::now();
+    for (int i = 0; i < 8; ++i) {
+        events::EventRing& ring = (i % 2 == 0) ? ring_1 : ring_2;
+        bool pushed = ring.push(events::ExecutionEvent(i, events::ExecutionEventType::request, ApplicationStage::forward, base + std::chrono::microseconds(i)));
+        assert(pushed);
+    }
+
+    std::vector<OperatorId> ops;
+    size_t count = events::EventRing::drain({&ring_1, &ring_2}, [&ops](const events::EventRing::Record& record) {
+        ops.push_back(std::get<events::ExecutionEvent>(record).op);
+    });
+    assert(count == 8);
+    for (size_t i = 0; i < ops.size(); ++i) assert(ops[i] == i);
+    assert(ring_1.empty() && ring_2.empty());
+}
+
+/**
+ * A full ring rejects pushing until drained by the consumer.
+ */
+static void testFull() {
+    events::EventRing ring;
+    for (size_t i = 0; i < events::EventRing::capacity; ++i) assert(ring.push(events::ExecutionEvent(0, events::ExecutionEventType::request, ApplicationStage::forward)));
+    assert(!ring.push(events::ExecutionEvent(0, events::ExecutionEventType::request, ApplicationStage::forward)));
+    assert(events::EventRing::drain({&ring}, [](const events::EventRing::Record&) {}) == events::EventRing::capacity);
+    assert(ring.push(events::ExecutionEvent(0, events::ExecutionEventType::request, ApplicationStage::forward)));
+}
+
+/**
+ * Producers wait for the consumer, and no record is lost or reordered within a ring.
+ */
+static void testConcurrent() {
+    constexpr size_t n = 100000;
+    events::EventRing ring_1, ring_2;
+    auto produce = [](events::EventRing& ring, OperatorId op) {
+        for (size_t i = 0; i < n; ++i) {
+            events::MemoryEvent event(op, i, 0, events::MemoryEventType::read, ApplicationStage::forward);
+            while (!ring.push(event)) std::this_thread::yield();
+        }
+    };
+    std::thread producer_1(produce, std::ref(ring_1), 1);
+    std::thread producer_2(produce, std::ref(ring_2), 2);
+
+    size_t count = 0;
+    TensorId next[3] = {0, 0, 0};
+    while (count < 2 * n) {
+        count += events::EventRing::drain({&ring_1, &ring_2}, [&](const events::EventRing::Record& record) {
+            const events::MemoryEvent& event = std::get<events::MemoryEvent>(record);
+            assert(event.tensor == next[event.op]++);
+        });
+    }
+    producer_1.join();
+    producer_2.join();
+    assert(next[1] == n && next[2] == n);
+}
+
+int main() {
+    testMerge();
+    testFull();
+    testConcurrent();
+    std::cout << "event ring tests passed." << std::endl;
+    return 0;
+}
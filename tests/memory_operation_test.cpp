@@ -0,0 +1,163 @@
+#include <mutex>
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#include "frontend/memory_operation_executor.hpp"
+
+using namespace mori;
+
+/**
+ * TwoDeviceMemoryManager
+ * Two devices emulated by host memory arenas, with a bump allocator on each.
+ */
+struct TwoDeviceMemoryManager final : public MemoryManager {
+private:
+    static constexpr size_t arena_size = 65536;
+    static constexpr size_t align_size = 256;
+
+    void*  arenas[2];
+    size_t offsets[2] = {0, 0};
+
+public:
+    int peer_copies = 0;
+    int frees       = 0;
+
+public:
+    TwoDeviceMemoryManager() {
+        for (auto &x : arenas) x = std::aligned_alloc(align_size, arena_size);
+    }
+
+    virtual void* allocateDevice(size_t size) override { return allocateDevice(0, size); }
+    virtual void* allocateDevice(DeviceId device, size_t size) override {
+        size_t aligned_size = utils::get_memory_aligned_size(size, align_size);
+        if (offsets[device] + aligned_size > arena_size) return nullptr;
+        void* re = (uint8_t*)arenas[device] + offsets[device];
+        offsets[device] += aligned_size;
+        return re;
+    }
+    virtual void* allocateHost(size_t size) override { return std::malloc(size); }
+
+    virtual void copyIn(void* host_address, void* device_address, size_t size) override { std::memcpy(device_address, host_address, size); }
+    virtual void copyOut(void* device_address, void* host_address, size_t size) override { std::memcpy(host_address, device_address, size); }
+    virtual void copyPeer(void* src, void* dst, size_t size) override {
+        ++peer_copies;
+        std::memcpy(dst, src, size);
+    }
+
+    virtual void freeDevice(void*) override { ++frees; }
+    virtual void freeHost(void* address) override { std::free(address); }
+
+    virtual bool isMemorySectionSupported() const override { return false; }
+
+    virtual MemoryInfo getMemoryInfo() const override {
+        MemoryInfo re = create_default_memory_info(arena_size, arena_size);
+        re.device.align_size = align_size;
+        re.device.common_block.address = arenas[0];
+        re.device.common_block.size    = arena_size;
+        re.peers.push_back(re.device);
+        re.peers[0].common_block.address = arenas[1];
+        return re;
+    }
+
+    virtual ~TwoDeviceMemoryManager() {
+        for (auto &x : arenas) std::free(x);
+    }
+};  // struct TwoDeviceMemoryManager
+
+/**
+ * Moving a tensor to the peer device keeps the data and the owning device, and frees the source region.
+ */
+static void testMigrate() {
+    TwoDeviceMemoryManager manager;
+    layout::MemoryLayout layout;
+    layout.setMemoryInfo(manager.getMemoryInfo());
+    MemoryOperationExecutor executor(layout);
+    executor.setMemoryManager(&manager);
+
+    MemoryStatus status;
+    TensorId tensor = status.registerTensor(status::Tensor("a", 1024));
+    TensorPres pres = status.referenceTensor(tensor);
+    void* address = manager.allocateDevice(0, 1024);
+    layout.recordMemoryAllocateEvent(address, 1024, tensor);
+    pres.setAllocated(address);
+    pres.setAssigned();
+    std::memset(address, 0x5a, 1024);
+
+    assert(executor.migrate(pres, 1));
+    void* moved = pres.getFirstSection().device_address;
+    assert(layout.getDeviceId(moved) == 1);
+    assert(pres.getDevice() == 0);
+    assert(manager.peer_copies == 1 && manager.frees == 1);
+    assert(((uint8_t*)moved)[0] == 0x5a && ((uint8_t*)moved)[1023] == 0x5a);
+    assert(!layout.getMemoryRegion(address).allocated);
+    assert(layout.getMemoryRegion(moved).allocated);
+
+    // Moving to the device where the data already is does nothing.
+    assert(executor.migrate(pres, 1));
+    assert(manager.peer_copies == 1);
+
+    // Moved back to the owning device.
+    assert(executor.migrate(pres, 0));
+    assert(layout.getDeviceId(pres.getFirstSection().device_address) == 0);
+    assert(!layout.getMemoryRegion(moved).allocated);
+    assert(manager.peer_copies == 2);
+}
+
+/**
+ * Data only located on host can not be moved.
+ */
+static void testMigrateHost() {
+    TwoDeviceMemoryManager manager;
+    layout::MemoryLayout layout;
+    layout.setMemoryInfo(manager.getMemoryInfo());
+    MemoryOperationExecutor executor(layout);
+    executor.setMemoryManager(&manager);
+
+    MemoryStatus status;
+    TensorId tensor = status.registerTensor(status::Tensor("a", 1024));
+    TensorPres pres = status.referenceTensor(tensor);
+    void* address = manager.allocateDevice(0, 1024);
+    layout.recordMemoryAllocateEvent(address, 1024, tensor);
+    pres.setAllocated(address);
+    pres.setAssigned();
+    executor.swapOut(pres, 1024);
+
+    assert(!executor.migrate(pres, 1));
+    assert(manager.peer_copies == 0);
+    executor.freeHost(pres, 1024);
+}
+
+/**
+ * Dropping frees the whole tensor on device without copying out.
+ */
+static void testDrop() {
+    TwoDeviceMemoryManager manager;
+    layout::MemoryLayout layout;
+    layout.setMemoryInfo(manager.getMemoryInfo());
+    MemoryOperationExecutor executor(layout);
+    executor.setMemoryManager(&manager);
+
+    MemoryStatus status;
+    TensorId tensor = status.registerTensor(status::Tensor("a", 1024));
+    TensorPres pres = status.referenceTensor(tensor);
+    void* address = manager.allocateDevice(0, 1024);
+    layout.recordMemoryAllocateEvent(address, 1024, tensor);
+    pres.setAllocated(address);
+    pres.setAssigned();
+
+    executor.drop(pres);
+    assert(pres.isDropped());
+    assert(!pres.isMemoryLocated());
+    assert(!layout.getMemoryRegion(address).allocated);
+    assert(manager.frees == 1);
+}
+
+int main() {
+    testMigrate();
+    testMigrateHost();
+    testDrop();
+    std::cout << "memory operation tests passed." << std::endl;
+    return 0;
+}
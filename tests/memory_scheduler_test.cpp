@@ -0,0 +1,85 @@
+#include <mutex>
+#include <cassert>
+#include <string>
+#include <iostream>
+
+#include "backend/events.hpp"
+#include "backend/schedulers/memory_scheduler.hpp"
+
+using namespace mori;
+
+static constexpr size_t operator_count = 100;
+static constexpr size_t tensor_count   = 4;
+
+/**
+ * Submit the events of an iteration. Optionally, a quarter of the tensors are passively swapped out at the middle of forward propagation,
+ * or a tensor is swapped in at forward propagation, which the schedule should have prevented.
+ */
+static void submitIteration(events::Events& events, bool passive, bool regressed) {
+    events.newIteration();
+    for (OperatorId op = 0; op < operator_count; ++op) {
+        for (size_t j = 0; j < tensor_count; ++j) {
+            TensorId tensor = op * tensor_count + j;
+            events.submitEvent(events::MemoryEvent(op, tensor, 1024, events::MemoryEventType::allocate, ApplicationStage::forward));
+            events.submitEvent(events::MemoryEvent(op, tensor, 1024, events::MemoryEventType::write, ApplicationStage::forward));
+            events.submitEvent(events::MemoryEvent(op, tensor, 1024, events::MemoryEventType::read, ApplicationStage::backward));
+        }
+        if (op != operator_count / 2) continue;
+        if (passive) {
+            for (TensorId tensor = 0; tensor < operator_count; tensor += tensor_count) {
+                events.submitEvent(events::MemoryEvent(op, tensor, 1024, events::MemoryEventType::swapout, ApplicationStage::forward));
+            }
+        }
+        if (regressed) events.submitEvent(events::MemoryEvent(op, 0, 1024, events::MemoryEventType::swapin, ApplicationStage::forward));
+    }
+}
+
+static size_t getScheduledCount(const events::ScheduleEvents& schedule_events) {
+    size_t re = 0;
+    for (auto &x : schedule_events.forward_schedule_events.execution) re += x.second.size();
+    return re;
+}
+
+/**
+ * On regression, the schedule is withdrawn and rebuilt from the next iteration, which shows the deficits by passive swapping.
+ */
+static void testReplan() {
+    status::MemoryStatus status;
+    for (OperatorId op = 0; op < operator_count; ++op) {
+        std::string op_name = "op" + std::to_string(op);
+        status::Operator op_status(op_name);
+        for (size_t j = 0; j < tensor_count; ++j) {
+            std::string tensor_name = op_name + "_t" + std::to_string(j);
+            status.registerTensor(status::Tensor(tensor_name, 1024));
+            op_status.setTensor(tensor_name);
+        }
+        if (op != 0) op_status.setPrev("op" + std::to_string(op - 1));
+        status.registerOperator(op_status);
+    }
+
+    Context context;
+    context["scheduler.replan"] = "true";
+    events::Events events;
+    DependencyAwareMemoryScheduler scheduler(context.view("scheduler"), status, events);
+
+    submitIteration(events, true, false);
+    size_t scheduled = getScheduledCount(scheduler.getScheduleEvents());
+    assert(scheduled != 0);
+
+    // Iterations under the schedule show no swapping out.
+    submitIteration(events, false, true);
+    assert(getScheduledCount(scheduler.getScheduleEvents()) == scheduled);
+    submitIteration(events, false, false);
+    assert(getScheduledCount(scheduler.getScheduleEvents()) == 0);
+
+    submitIteration(events, true, false);
+    assert(getScheduledCount(scheduler.getScheduleEvents()) == scheduled);
+    submitIteration(events, false, false);
+    assert(getScheduledCount(scheduler.getScheduleEvents()) == scheduled);
+}
+
+int main() {
+    testReplan();
+    std::cout << "memory scheduler tests passed." << std::endl;
+    return 0;
+}
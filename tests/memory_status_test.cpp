@@ -0,0 +1,210 @@
+#include <cassert>
+#include <iostream>
+#include <thread>
+
+#include "includes/memory_status.hpp"
+
+using namespace mori;
+
+/**
+ * Trying to reference a tensor held by the same thread should fail instead of waiting.
+ */
+static void testTryReferenceHeld() {
+    MemoryStatus status;
+    status.registerTensor("a");
+
+    TensorPres pres = status.referenceTensor("a");
+    status::TensorView view = status.tryReferenceTensor("a");
+    assert(!view.isReferenced());
+
+    // Presentations of a status copy do not make the hold shared.
+    MemoryStatus copy = status;
+    status::TensorView copy_view = copy.tryReferenceTensor("a");
+    assert(!copy_view.isReferenced());
+}
+
+/**
+ * Copies behave as independent snapshots once referenced.
+ */
+static void testCopyDetached() {
+    MemoryStatus status;
+    status.registerTensor("a");
+    MemoryStatus copy = status;
+
+    copy.referenceTensor("a").setReshaped(1024);
+    assert(copy.referenceConstTensor("a").getSize() == 1024);
+    assert(status.referenceConstTensor("a").getSize() == 0);
+
+    status.referenceTensor("a").setReshaped(512);
+    assert(copy.referenceConstTensor("a").getSize() == 1024);
+    assert(status.referenceConstTensor("a").getSize() == 512);
+}
+
+/**
+ * Concurrent modifications through references of the same status are never lost, while the status is copied.
+ */
+static void testConcurrentReference() {
+    MemoryStatus status;
+    TensorId tensor = status.registerTensor("a");
+    status.setConcurrent(true);
+
+    constexpr int n = 1000;
+    std::thread worker([&]() {
+        for (int i = 0; i < n; ++i) {
+            TensorPres pres = status.referenceTensor(tensor);
+            pres.setReshaped(pres.getSize() + 1);
+        }
+    });
+    for (int i = 0; i < n; ++i) {
+        MemoryStatus copy = status;
+        TensorPres pres = status.referenceTensor(tensor);
+        pres.setReshaped(pres.getSize() + 1);
+    }
+    worker.join();
+    assert(status.referenceConstTensor(tensor).getSize() == 2 * n);
+}
+
+/**
+ * Lookup results remain valid after the tables are replaced and reclaimed.
+ */
+static void testTablesSnapshot() {
+    MemoryStatus status;
+    status.setConcurrent(true);
+    for (int i = 0; i < 100; ++i) {
+        std::string name = "t" + std::to_string(i);
+        status.registerTensor(name);
+        status::Operator op("op" + std::to_string(i));
+        op.setTensor(name);
+        status.registerOperator(op);
+    }
+
+    auto order = status.getExecutionOrder();
+    auto operators = status.getOperators();
+    std::string name = status.getTensorName(42);
+    status.unregisterOperator("op0");
+    status.registerTensor("t100");
+    status.reclaim();
+
+    assert(order.size() == 100 && order[0] == "op0" && order[99] == "op99");
+    assert(name == "t42");
+    assert(operators.size() == 100 && operators.contains("op0"));
+    assert(std::distance(operators.begin(), operators.end()) == 100);
+    assert(status.getExecutionOrder().size() == 99);
+    assert(status.getExecutionPosition("op99") == 98);
+    assert(status.getTensorId("t100") == 100);
+    assert(status.getOperators().size() == 99);
+}
+
+/**
+ * Lookups run concurrently with registrations.
+ */
+static void testConcurrentRegistration() {
+    MemoryStatus status;
+    status.registerTensor("a");
+    status.setConcurrent(true);
+
+    constexpr int n = 2000;
+    std::thread worker([&]() {
+        for (int i = 0; i < n; ++i) status.registerTensor("t" + std::to_string(i));
+    });
+    for (int i = 0; i < n; ++i) {
+        assert(status.getTensorId("a") == 0);
+        assert(status.getTensorName(0) == "a");
+        assert(status.isTensorRegistered(0));
+        assert(status.referenceConstTensor(0).getName() == "a");
+        status.reclaim();
+    }
+    worker.join();
+    assert(status.getTensors().size() == n + 1);
+    assert(status.getTensorName(n) == "t" + std::to_string(n - 1));
+}
+
+/**
+ * Unregistered tensors are removed from the operators they belong to.
+ */
+static void testUnregisterTensor() {
+    MemoryStatus status;
+    TensorId a = status.registerTensor("a");
+    status.registerTensor("b");
+    status::Operator op("op");
+    op.setTensor("a");
+    op.setTensor("b");
+    OperatorId id = status.registerOperator(op);
+    MemoryStatus copy = status;
+
+    status.unregisterTensor("a");
+    status::ConstOperatorPres pres = status.referenceConstOperator(id);
+    assert(pres.getTensors().count("a") == 0 && pres.getTensors().count("b") == 1);
+    assert(pres.getTensorIds().size() == 1 && pres.getTensorIds()[0] == a + 1);
+    assert(!status.isTensorRegistered(a));
+
+    // The copy is not affected.
+    assert(copy.referenceConstOperator(id).getTensorIds().size() == 2);
+}
+
+/**
+ * Operators left out of the execution order can be unregistered.
+ */
+static void testUnregisterUnordered() {
+    MemoryStatus status;
+    status.registerOperator(status::Operator("a"));
+    status.registerOperator(status::Operator("b"));
+    status.setExecutionOrder(std::vector<std::string>{"b"});
+
+    status.unregisterOperator("a");
+    assert(!status.isOperatorRegistered("a"));
+    assert(status.getExecutionOrder().size() == 1 && status.getExecutionPosition("b") == 0);
+}
+
+/**
+ * Deltas keep a copy in step with the source, without discarding the modifications of the copy.
+ */
+static void testDelta() {
+    MemoryStatus status;
+    status.registerTensor("a");
+    MemoryStatus copy = status;
+    copy.referenceTensor("a").setFragment(64);
+
+    status::MemoryStatusDelta delta;
+    TensorId tensor = status.registerTensor("b");
+    delta.registered_tensors.push_back(status.referenceConstTensor(tensor).get());
+    status::Operator op("op");
+    op.setTensor("b");
+    OperatorId id = status.registerOperator(op);
+    delta.registered_operators.push_back(status.referenceConstOperator(id).get());
+    copy.apply(delta);
+
+    assert(copy.getTensorId("b") == tensor);
+    assert(copy.referenceConstTensor("b").get().getOperatorId() == id);
+    assert(copy.getExecutionPosition("op") == 0);
+    assert(copy.referenceConstTensor("a").hasFragment());
+
+    status::MemoryStatusDelta removal;
+    removal.unregistered_operators.push_back("op");
+    removal.unregistered_tensors.push_back("b");
+    copy.apply(removal);
+    assert(!copy.isTensorRegistered("b") && !copy.isOperatorRegistered("op"));
+    assert(status.isTensorRegistered("b"));
+
+    // Applying out of order is rejected.
+    bool rejected = false;
+    try {
+        copy.apply(delta);
+    } catch (status_exception& e) {
+        rejected = true;
+    }
+    assert(rejected);
+}
+
+int main() {
+    testTryReferenceHeld();
+    testCopyDetached();
+    testConcurrentReference();
+    testTablesSnapshot();
+    testConcurrentRegistration();
+    testUnregisterTensor();
+    testUnregisterUnordered();
+    testDelta();
+    std::cout << "memory status tests passed." << std::endl;
+    return 0;
+}